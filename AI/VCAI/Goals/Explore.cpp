@@ -63,7 +63,7 @@ namespace Goals
 				{
 					int3 tile = int3(x, y, ourPos.z);
 
-					if(cbp->isInTheMap(tile) && ts->fogOfWarMap[tile.x][tile.y][tile.z])
+					if(cbp->isInTheMap(tile) && ts->fogOfWarMap.contains(tile))
 					{
 						scanTile(tile);
 					}
@@ -84,13 +84,13 @@ namespace Goals
 
 			foreach_tile_pos([&](const int3 & pos)
 			{
-				if(ts->fogOfWarMap[pos.x][pos.y][pos.z])
+				if(ts->fogOfWarMap.contains(pos))
 				{
 					bool hasInvisibleNeighbor = false;
 
 					foreach_neighbour(cbp, pos, [&](CCallback * cbp, int3 neighbour)
 					{
-						if(!ts->fogOfWarMap[neighbour.x][neighbour.y][neighbour.z])
+						if(!ts->fogOfWarMap.contains(neighbour))
 						{
 							hasInvisibleNeighbor = true;
 						}
@@ -174,7 +174,7 @@ namespace Goals
 			{
 				foreach_neighbour(cbp, tile, [&](CCallback * cbp, int3 neighbour)
 				{
-					if(ts->fogOfWarMap[neighbour.x][neighbour.y][neighbour.z])
+					if(ts->fogOfWarMap.contains(neighbour))
 					{
 						out.push_back(neighbour);
 					}
@@ -193,7 +193,7 @@ namespace Goals
 					int3 npos = int3(x, y, pos.z);
 					if(cbp->isInTheMap(npos)
 						&& pos.dist2d(npos) - 0.5 < sightRadius
-						&& !ts->fogOfWarMap[npos.x][npos.y][npos.z])
+						&& !ts->fogOfWarMap.contains(npos))
 					{
 						if(allowDeadEndCancellation
 							&& !hasReachableNeighbor(npos))
@@ -417,23 +417,16 @@ TSubgoal Explore::exploreNearestNeighbour(HeroPtr h) const
 	const float COST_LIMIT = .2f; //todo: fine tune
 
 	std::vector<const CGObjectInstance *> nearbyVisitableObjs;
-	for(int x = hpos.x - DIST_LIMIT; x <= hpos.x + DIST_LIMIT; ++x) //get only local objects instead of all possible objects on the map
+	for(auto obj : cb->getVisitableObjsAround(hpos, DIST_LIMIT)) //get only local objects instead of all possible objects on the map
 	{
-		for(int y = hpos.y - DIST_LIMIT; y <= hpos.y + DIST_LIMIT; ++y)
+		if(ai->isGoodForVisit(obj, h, COST_LIMIT))
 		{
-			for(auto obj : cb->getVisitableObjs(int3(x, y, hpos.z), false))
-			{
-				if(ai->isGoodForVisit(obj, h, COST_LIMIT))
-				{
-					nearbyVisitableObjs.push_back(obj);
-				}
-			}
+			nearbyVisitableObjs.push_back(obj);
 		}
 	}
 
 	if(nearbyVisitableObjs.size())
 	{
-		vstd::removeDuplicates(nearbyVisitableObjs); //one object may occupy multiple tiles
 		boost::sort(nearbyVisitableObjs, CDistanceSorter(h.get()));
 
 		TSubgoal pickupNearestObj = fh->chooseSolution(ai->ah->howToVisitObj(h, nearbyVisitableObjs.back(), false));
@@ -82,21 +82,14 @@ const SectorMap::TSectorID & SectorMap::retrieveTileN(const SectorMap::TSectorAr
 void SectorMap::clear()
 {
 	//TODO: rotate to [z][x][y]
-	auto fow = cb->getVisibilityMap();
-	//TODO: any magic to automate this? will need array->array conversion
-	//std::transform(fow.begin(), fow.end(), sector.begin(), [](const ui8 &f) -> unsigned short
-	//{
-	//	return f; //type conversion
-	//});
-	auto width = fow.size();
-	auto height = fow.front().size();
-	auto depth = fow.front().front().size();
-	for (size_t x = 0; x < width; x++)
+	const auto & fow = cb->getVisibilityMap();
+	const int3 & sizes = fow.getMapSize();
+	for (int x = 0; x < sizes.x; x++)
 	{
-		for (size_t y = 0; y < height; y++)
+		for (int y = 0; y < sizes.y; y++)
 		{
-			for (size_t z = 0; z < depth; z++)
-				sector[x][y][z] = fow[x][y][z];
+			for (int z = 0; z < sizes.z; z++)
+				sector[x][y][z] = fow.contains(int3(x, y, z));
 		}
 	}
 	valid = false;
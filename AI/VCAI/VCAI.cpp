@@ -1672,26 +1672,20 @@ void VCAI::validateVisitableObjs()
 
 void VCAI::retrieveVisitableObjs(std::vector<const CGObjectInstance *> & out, bool includeOwned) const
 {
-	foreach_tile_pos([&](const int3 & pos)
+	for(const CGObjectInstance * obj : myCb->getAllVisitableObjs())
 	{
-		for(const CGObjectInstance * obj : myCb->getVisitableObjs(pos, false))
-		{
-			if(includeOwned || obj->tempOwner != playerID)
-				out.push_back(obj);
-		}
-	});
+		if(includeOwned || obj->tempOwner != playerID)
+			out.push_back(obj);
+	}
 }
 
 void VCAI::retrieveVisitableObjs()
 {
-	foreach_tile_pos([&](const int3 & pos)
+	for(const CGObjectInstance * obj : myCb->getAllVisitableObjs())
 	{
-		for(const CGObjectInstance * obj : myCb->getVisitableObjs(pos, false))
-		{
-			if(obj->tempOwner != playerID)
-				addVisitableObj(obj);
-		}
-	});
+		if(obj->tempOwner != playerID)
+			addVisitableObj(obj);
+	}
 }
 
 std::vector<const CGObjectInstance *> VCAI::getFlaggedObjects() const
@@ -246,9 +246,9 @@ void CCallback::recruitHero(const CGObjectInstance *townOrTavern, const CGHeroIn
 	}
 }
 
-void CCallback::save( const std::string &fname )
+void CCallback::save( const std::string &fname, bool allowDelta )
 {
-	cl->save(fname);
+	cl->save(fname, allowDelta);
 }
 
 
@@ -296,7 +296,7 @@ int3 CCallback::getGuardingCreaturePosition(int3 tile)
 	if (!gs->map->isInTheMap(tile))
 		return int3(-1,-1,-1);
 
-	return gs->map->guardingCreaturePositions[tile.x][tile.y][tile.z];
+	return gs->map->getGuardingCreaturePosition(tile);
 }
 
 void CCallback::calculatePaths( const CGHeroInstance *hero, CPathsInfo &out)
@@ -181,7 +181,7 @@ void CPlayerInterface::yourTurn()
 		}
 		else if(frequency > 0 && cb->getDate() % frequency == 0)
 		{
-			LOCPLINT->cb->save("Saves/" + prefix + "Autosave_" + boost::lexical_cast<std::string>(autosaveCount++ + 1));
+			LOCPLINT->cb->save("Saves/" + prefix + "Autosave_" + boost::lexical_cast<std::string>(autosaveCount++ + 1), true);
 			autosaveCount %= 5;
 		}
 
@@ -155,6 +155,15 @@ void CClient::loadGame()
 		if(controlServerSaveName.empty() || !boost::filesystem::exists(controlServerSaveName))
 			throw std::runtime_error("Cannot open server part of " + CSH->si->mapname);
 
+		if(isDeltaSave(controlServerSaveName))
+		{
+			// Client part of delta save has no game state, it is restored by replaying server part
+			CLoadFile serverLoader(controlServerSaveName, MINIMAL_SERIALIZATION_VERSION);
+			loadCommonState(serverLoader);
+			loader = make_unique<CLoadFile>(clientSaveName, MINIMAL_SERIALIZATION_VERSION);
+			loadCommonState(*loader);
+		}
+		else
 		{
 			CLoadIntegrityValidator checkingLoader(clientSaveName, controlServerSaveName, MINIMAL_SERIALIZATION_VERSION);
 			loadCommonState(checkingLoader);
@@ -256,7 +265,7 @@ void CClient::serialize(BinaryDeserializer & h, const int version)
 	logNetwork->trace("Loaded client part of save %d ms", CSH->th->getDiff());
 }
 
-void CClient::save(const std::string & fname)
+void CClient::save(const std::string & fname, bool allowDelta)
 {
 	if(gs->curB)
 	{
@@ -264,7 +273,7 @@ void CClient::save(const std::string & fname)
 		return;
 	}
 
-	SaveGame save_game(fname);
+	SaveGame save_game(fname, allowDelta);
 	sendRequest(&save_game, PlayerColor::NEUTRAL);
 }
 
@@ -127,7 +127,7 @@ public:
 	void serialize(BinarySerializer & h, const int version);
 	void serialize(BinaryDeserializer & h, const int version);
 
-	void save(const std::string & fname);
+	void save(const std::string & fname, bool allowDelta = false);
 	void endGame();
 
 	void initMapHandler();
@@ -210,5 +210,5 @@ public:
 	void heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2) override {};
 
 	void changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide) override {}
-	void changeFogOfWar(std::unordered_set<int3, ShashInt3> & tiles, PlayerColor player, bool hide) override {}
+	void changeFogOfWar(const CTileSet & tiles, PlayerColor player, bool hide) override {}
 };
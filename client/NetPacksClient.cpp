@@ -18,6 +18,7 @@
 #include "CGameInfo.h"
 #include "../lib/serializer/Connection.h"
 #include "../lib/serializer/BinarySerializer.h"
+#include "../lib/serializer/CStateDigest.h"
 #include "../lib/CGeneralTextHandler.h"
 #include "../lib/CHeroHandler.h"
 #include "../lib/VCMI_Lib.h"
@@ -178,6 +179,7 @@ void SetMovePoints::applyCl(CClient *cl)
 
 void FoWChange::applyCl(CClient *cl)
 {
+	const std::unordered_set<int3, ShashInt3> changedTiles(tiles.begin(), tiles.end());
 	for(auto &i : cl->playerint)
 	{
 		if(cl->getPlayerRelations(i.first, player) == PlayerRelations::SAME_PLAYER && waitForDialogs && LOCPLINT == i.second.get())
@@ -187,9 +189,9 @@ void FoWChange::applyCl(CClient *cl)
 		if(cl->getPlayerRelations(i.first, player) != PlayerRelations::ENEMIES)
 		{
 			if(mode)
-				i.second->tileRevealed(tiles);
+				i.second->tileRevealed(changedTiles);
 			else
-				i.second->tileHidden(tiles);
+				i.second->tileHidden(changedTiles);
 		}
 	}
 	cl->invalidatePaths();
@@ -778,7 +780,10 @@ void SaveGameClient::applyCl(CClient *cl)
 	try
 	{
 		CSaveFile save(*CResourceHandler::get()->getResourceName(ResourceID(stem.to_string(), EResType::CLIENT_SAVEGAME)));
-		cl->saveCommonState(save);
+		if(delta)
+			cl->saveCommonStateDelta(save, checkpoint, nullptr);
+		else
+			cl->saveCommonState(save, checkpoint);
 		save << *cl;
 	}
 	catch(std::exception &e)
@@ -800,6 +805,22 @@ void PlayerMessageClient::applyCl(CClient *cl)
 		LOCPLINT->cingconsole->print(str.str());
 }
 
+void GameStateDigest::applyFirstCl(CClient *cl)
+{
+	const CStateDigest & own = GS(cl)->getStateDigest();
+	const ui32 ownSummary = CStateDigest::summary(GS(cl));
+
+	if(own.size() != packsCount || own.value() != digest || ownSummary != summary)
+	{
+		logNetwork->error("Game state is out of sync with server! Applied packs: %d (server: %d), digest: %08x (server: %08x), summary: %08x (server: %08x)",
+			own.size(), packsCount, own.value(), digest, ownSummary, summary);
+	}
+	else
+	{
+		logNetwork->debug("Game state digest %08x matches server after %d packs", digest, packsCount);
+	}
+}
+
 void ShowInInfobox::applyCl(CClient *cl)
 {
 	callInterfaceIfPresent(cl, player, &IGameEventsReceiver::showComp, c, text.toString());
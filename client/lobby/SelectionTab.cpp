@@ -35,6 +35,8 @@
 #include "../../lib/CModHandler.h"
 #include "../../lib/filesystem/Filesystem.h"
 #include "../../lib/mapping/CMapInfo.h"
+#include "../../lib/mapping/CMapInfoCache.h"
+#include "../../lib/VCMIDirs.h"
 #include "../../lib/serializer/Connection.h"
 
 
@@ -505,77 +507,76 @@ void SelectionTab::restoreLastSelection()
 	}
 }
 
+static CMapInfoCache & getMapInfoCache()
+{
+	static CMapInfoCache cache(VCMIDirs::get().userCachePath() / "mapInfoCache.vcache");
+	return cache;
+}
+
 void SelectionTab::parseMaps(const std::unordered_set<ResourceID> & files)
 {
 	logGlobal->debug("Parsing %d maps", files.size());
 	allItems.clear();
-	for(auto & file : files)
+	auto mapInfos = getMapInfoCache().load(files, [](CMapInfo & mapInfo, const ResourceID & file)
 	{
-		try
-		{
-			auto mapInfo = std::make_shared<CMapInfo>();
-			mapInfo->mapInit(file.getName());
+		mapInfo.mapInit(file.getName());
+	});
+	getMapInfoCache().save();
 
-			// ignore unsupported map versions (e.g. WoG maps without WoG)
-			// but accept VCMI maps
-			if((mapInfo->mapHeader->version >= EMapFormat::VCMI) || (mapInfo->mapHeader->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
-				allItems.push_back(mapInfo);
-		}
-		catch(std::exception & e)
-		{
-			logGlobal->error("Map %s is invalid. Message: %s", file.getName(), e.what());
-		}
+	for(auto & mapInfo : mapInfos)
+	{
+		// ignore unsupported map versions (e.g. WoG maps without WoG)
+		// but accept VCMI maps
+		if((mapInfo->mapHeader->version >= EMapFormat::VCMI) || (mapInfo->mapHeader->version <= CGI->modh->settings.data["textData"]["mapVersion"].Float()))
+			allItems.push_back(mapInfo);
 	}
 }
 
 void SelectionTab::parseSaves(const std::unordered_set<ResourceID> & files)
 {
-	for(auto & file : files)
+	auto mapInfos = getMapInfoCache().load(files, [](CMapInfo & mapInfo, const ResourceID & file)
 	{
-		try
-		{
-			auto mapInfo = std::make_shared<CMapInfo>();
-			mapInfo->saveInit(file);
-
-			// Filter out other game modes
-			bool isCampaign = mapInfo->scenarioOptionsOfSave->mode == StartInfo::CAMPAIGN;
-			bool isMultiplayer = mapInfo->amountOfHumanPlayersInSave > 1;
-			switch(CSH->getLoadMode())
-			{
-			case ELoadMode::SINGLE:
-				if(isMultiplayer || isCampaign)
-					mapInfo->mapHeader.reset();
-				break;
-			case ELoadMode::CAMPAIGN:
-				if(!isCampaign)
-					mapInfo->mapHeader.reset();
-				break;
-			default:
-				if(!isMultiplayer)
-					mapInfo->mapHeader.reset();
-				break;
-			}
+		mapInfo.saveInit(file);
+	});
+	getMapInfoCache().save();
 
-			allItems.push_back(mapInfo);
-		}
-		catch(const std::exception & e)
+	for(auto & mapInfo : mapInfos)
+	{
+		// Filter out other game modes
+		bool isCampaign = mapInfo->scenarioOptionsOfSave->mode == StartInfo::CAMPAIGN;
+		bool isMultiplayer = mapInfo->amountOfHumanPlayersInSave > 1;
+		switch(CSH->getLoadMode())
 		{
-			logGlobal->error("Error: Failed to process %s: %s", file.getName(), e.what());
+		case ELoadMode::SINGLE:
+			if(isMultiplayer || isCampaign)
+				mapInfo->mapHeader.reset();
+			break;
+		case ELoadMode::CAMPAIGN:
+			if(!isCampaign)
+				mapInfo->mapHeader.reset();
+			break;
+		default:
+			if(!isMultiplayer)
+				mapInfo->mapHeader.reset();
+			break;
 		}
+
+		allItems.push_back(mapInfo);
 	}
 }
 
 void SelectionTab::parseCampaigns(const std::unordered_set<ResourceID> & files)
 {
 	allItems.reserve(files.size());
-	for(auto & file : files)
+	auto mapInfos = getMapInfoCache().load(files, [](CMapInfo & mapInfo, const ResourceID & file)
 	{
-		auto info = std::make_shared<CMapInfo>();
 		//allItems[i].date = std::asctime(std::localtime(&files[i].date));
-		info->fileURI = file.getName();
-		info->campaignInit();
-		allItems.push_back(info);
-	}
+		mapInfo.fileURI = file.getName();
+		mapInfo.campaignInit();
+	});
+	getMapInfoCache().save();
+
+	boost::range::copy(mapInfos, std::back_inserter(allItems));
 }
 
 std::unordered_set<ResourceID> SelectionTab::getFiles(std::string dirURI, int resType)
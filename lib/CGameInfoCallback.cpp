@@ -448,6 +448,45 @@ std::vector <const CGObjectInstance * > CGameInfoCallback::getVisitableObjs(int3
 
 	return ret;
 }
+bool CGameInfoCallback::isVisitableFromVisibleTile(const CGObjectInstance * obj) const
+{
+	if(!obj->isVisitable() || (!player && obj->ID == Obj::EVENT)) //same rules as getVisitableObjs
+		return false;
+
+	for(int fx = 0; fx < obj->getWidth(); fx++)
+	{
+		for(int fy = 0; fy < obj->getHeight(); fy++)
+		{
+			int3 tile = obj->pos - int3(fx, fy, 0);
+			if(obj->visitableAt(tile.x, tile.y) && isVisible(tile))
+				return true;
+		}
+	}
+	return false;
+}
+
+std::vector <const CGObjectInstance * > CGameInfoCallback::getVisitableObjsAround(int3 pos, int distance) const
+{
+	std::vector<const CGObjectInstance *> ret;
+	for(const CGObjectInstance * obj : gs->map->objectIndex.getObjectsInRect(pos - int3(distance, distance, 0), pos + int3(distance, distance, 0)))
+	{
+		if(isVisitableFromVisibleTile(obj))
+			ret.push_back(obj);
+	}
+	return ret;
+}
+
+std::vector <const CGObjectInstance * > CGameInfoCallback::getAllVisitableObjs() const
+{
+	std::vector<const CGObjectInstance *> ret;
+	for(const CGObjectInstance * obj : gs->map->objectIndex.getAllObjects())
+	{
+		if(isVisitableFromVisibleTile(obj))
+			ret.push_back(obj);
+	}
+	return ret;
+}
+
 const CGObjectInstance * CGameInfoCallback::getTopObj (int3 pos) const
 {
 	return vstd::backOrNull(getVisitableObjs(pos));
@@ -511,7 +550,7 @@ std::shared_ptr<boost::multi_array<TerrainTile*, 3>> CGameInfoCallback::getAllVi
 		for (size_t y = 0; y < height; y++)
 			for (size_t z = 0; z < levels; z++)
 			{
-				if (team->fogOfWarMap[x][y][z])
+				if (team->fogOfWarMap.contains(int3((si32)x, (si32)y, (si32)z)))
 					tileArray[x][y][z] = &gs->map->getTile(int3((si32)x, (si32)y, (si32)z));
 				else
 					tileArray[x][y][z] = nullptr;
@@ -687,7 +726,7 @@ CGameInfoCallback::CGameInfoCallback(CGameState *GS, boost::optional<PlayerColor
 	player = Player;
 }
 
-const std::vector< std::vector< std::vector<ui8> > > & CPlayerSpecificInfoCallback::getVisibilityMap() const
+const CTileSet & CPlayerSpecificInfoCallback::getVisibilityMap() const
 {
 	//boost::shared_lock<boost::shared_mutex> lock(*gs->mx);
 	return gs->getPlayerTeam(*player)->fogOfWarMap;
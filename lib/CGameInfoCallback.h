@@ -30,6 +30,7 @@ class CMapHeader;
 struct TeamState;
 struct QuestInfo;
 struct ShashInt3;
+class CTileSet;
 class CGameState;
 class PathfinderConfig;
 
@@ -48,6 +49,8 @@ protected:
 
 	bool canGetFullInfo(const CGObjectInstance *obj) const; //true we player owns obj or ally owns obj or privileged mode
 	bool isOwnedOrVisited(const CGObjectInstance *obj) const;
+	/// true if getVisitableObjs returns obj for any of its tiles
+	bool isVisitableFromVisibleTile(const CGObjectInstance *obj) const;
 
 public:
 	//various
@@ -85,6 +88,10 @@ public:
 	virtual const CGObjectInstance* getObj(ObjectInstanceID objid, bool verbose = true) const;
 	virtual std::vector <const CGObjectInstance * > getBlockingObjs(int3 pos)const;
 	virtual std::vector <const CGObjectInstance * > getVisitableObjs(int3 pos, bool verbose = true)const;
+	/// visible visitable objects with visitable position at most distance tiles away from pos in each direction, each of them once
+	virtual std::vector <const CGObjectInstance * > getVisitableObjsAround(int3 pos, int distance) const;
+	/// all visible visitable objects on the map, each of them once
+	virtual std::vector <const CGObjectInstance * > getAllVisitableObjs() const;
 	virtual std::vector <const CGObjectInstance * > getFlaggableObjects(int3 pos) const;
 	virtual const CGObjectInstance * getTopObj (int3 pos) const;
 	virtual PlayerColor getOwner(ObjectInstanceID heroID) const;
@@ -146,7 +153,7 @@ public:
 
 	virtual int getResourceAmount(Res::ERes type) const;
 	virtual TResources getResourceAmount() const;
-	virtual const std::vector< std::vector< std::vector<ui8> > > & getVisibilityMap()const; //returns visibility map
+	virtual const CTileSet & getVisibilityMap()const; //returns visibility map
 	//virtual const PlayerSettings * getPlayerSettings(PlayerColor color) const;
 };
 
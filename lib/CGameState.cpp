@@ -35,6 +35,7 @@
 #include "mapping/CMapEditManager.h"
 #include "serializer/CTypeList.h"
 #include "serializer/CMemorySerializer.h"
+#include "serializer/CStateDigest.h"
 #include "VCMIDirs.h"
 
 boost::shared_mutex CGameState::mutex;
@@ -54,12 +55,16 @@ public:
 
 template <typename T> class CApplyOnGS : public CBaseForGSApply
 {
+	//packs without own applyGs do not change game state and may be sent to clients without applying them on server
+	static const bool changesState = !std::is_same<decltype(&T::applyGs), void (CPack::*)(CGameState *)>::value;
 public:
 	void applyOnGS(CGameState *gs, void *pack) const override
 	{
 		T *ptr = static_cast<T*>(pack);
 
 		boost::unique_lock<boost::shared_mutex> lock(CGameState::mutex);
+		if(changesState)
+			gs->stateDigest->update(gs, ptr);
 		ptr->applyGs(gs);
 	}
 };
@@ -671,6 +676,7 @@ int CGameState::getDate(Date::EDateType mode) const
 CGameState::CGameState()
 {
 	gs = this;
+	stateDigest = make_unique<CStateDigest>();
 	applier = std::make_shared<CApplier<CBaseForGSApply>>();
 	registerTypesClientPacks1(*applier);
 	registerTypesClientPacks2(*applier);
@@ -731,6 +737,7 @@ void CGameState::init(const IMapService * mapService, StartInfo * si, bool allow
 	initMapObjects();
 	buildBonusSystemTree();
 	initVisitingAndGarrisonedHeroes();
+	map->rebuildObjectIndex(); //random objects got their types and owners
 	initFogOfWar();
 
 	// Explicitly initialize static variables
@@ -1516,33 +1523,29 @@ void CGameState::initFogOfWar()
 	logGlobal->debug("\tFog of war"); //FIXME: should be initialized after all bonuses are set
 	for(auto & elem : teams)
 	{
-		elem.second.fogOfWarMap.resize(map->width);
-		for(int g=0; g<map->width; ++g)
-			elem.second.fogOfWarMap[g].resize(map->height);
-
-		for(int g=-0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				elem.second.fogOfWarMap[g][h].resize(map->twoLevel ? 2 : 1, 0);
-
-		for(int g=0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				for(int v = 0; v < (map->twoLevel ? 2 : 1); ++v)
-					elem.second.fogOfWarMap[g][h][v] = 0;
+		elem.second.fogOfWarMap = CTileSet(int3(map->width, map->height, map->twoLevel ? 2 : 1));
 
 		for(CGObjectInstance *obj : map->objects)
 		{
 			if(!obj || !vstd::contains(elem.second.players, obj->tempOwner)) continue; //not a flagged object
 
-			std::unordered_set<int3, ShashInt3> tiles;
+			CTileSet tiles;
 			getTilesInRange(tiles, obj->getSightCenter(), obj->getSightRadius(), obj->tempOwner, 1);
-			for(int3 tile : tiles)
-			{
-				elem.second.fogOfWarMap[tile.x][tile.y][tile.z] = 1;
-			}
+			elem.second.fogOfWarMap |= tiles;
 		}
 	}
 }
 
+void CGameState::checkFogOfWar() const
+{
+	const int3 mapSize(map->width, map->height, map->twoLevel ? 2 : 1);
+	for(auto & elem : teams)
+	{
+		if(elem.second.fogOfWarMap.getMapSize() != mapSize)
+			throw std::runtime_error("Fog of war of team " + boost::lexical_cast<std::string>(elem.first.getNum()) + " doesn't match size of map " + mapSize.toString());
+	}
+}
+
 void CGameState::initStartingBonus()
 {
 	if (scenarioOps->mode == StartInfo::CAMPAIGN)
@@ -1972,6 +1975,11 @@ void CGameState::apply(CPack *pack)
 	applier->getApplier(typ)->applyOnGS(this, pack);
 }
 
+const CStateDigest & CGameState::getStateDigest() const
+{
+	return *stateDigest;
+}
+
 void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
 {
 	CPathfinder pathfinder(out, this, hero);
@@ -2041,7 +2049,7 @@ std::vector<CGObjectInstance*> CGameState::guardingCreatures (int3 pos) const
 
 int3 CGameState::guardingCreaturePosition (int3 pos) const
 {
-	return gs->map->guardingCreaturePositions[pos.x][pos.y][pos.z];
+	return gs->map->getGuardingCreaturePosition(pos);
 }
 
 void CGameState::updateRumor()
@@ -2125,7 +2133,7 @@ bool CGameState::isVisible(int3 pos, PlayerColor player)
 	if(player.isSpectator())
 		return true;
 
-	return getPlayerTeam(player)->fogOfWarMap[pos.x][pos.y][pos.z];
+	return getPlayerTeam(player)->fogOfWarMap.contains(pos);
 }
 
 bool CGameState::isVisible( const CGObjectInstance *obj, boost::optional<PlayerColor> player )
@@ -2807,6 +2815,9 @@ void CGameState::replaceHeroesPlaceholders(const std::vector<CGameState::Campaig
 	{
 		auto heroPlaceholder = dynamic_cast<CGHeroPlaceholder*>(getObjInstance(campaignHeroReplacement.heroPlaceholderId));
 
+		//placeholder must leave its tiles and object index before hero takes its id
+		map->removeBlockVisTiles(heroPlaceholder, true);
+
 		CGHeroInstance *heroToPlace = campaignHeroReplacement.hero;
 		heroToPlace->id = campaignHeroReplacement.heroPlaceholderId;
 		heroToPlace->tempOwner = heroPlaceholder->tempOwner;
@@ -3099,6 +3110,20 @@ TeamState::TeamState(TeamState && other):
 	std::swap(fogOfWarMap, other.fogOfWarMap);
 }
 
+void TeamState::loadOldFogOfWarMap(const std::vector<std::vector<std::vector<ui8> > > & oldFogOfWarMap)
+{
+	const int width = static_cast<int>(oldFogOfWarMap.size());
+	const int height = width ? static_cast<int>(oldFogOfWarMap[0].size()) : 0;
+	const int levels = height ? static_cast<int>(oldFogOfWarMap[0][0].size()) : 0;
+
+	fogOfWarMap = CTileSet(int3(width, height, levels));
+	for(int x = 0; x < width; x++)
+		for(int y = 0; y < height; y++)
+			for(int z = 0; z < levels; z++)
+				if(oldFogOfWarMap[x][y][z])
+					fogOfWarMap.insert(int3(x, y, z));
+}
+
 CRandomGenerator & CGameState::getRandomGenerator()
 {
 	return rand;
@@ -61,7 +61,9 @@ namespace boost
 }
 
 template<typename T> class CApplier;
+template<typename T> class CApplyOnGS;
 class CBaseForGSApply;
+class CStateDigest;
 
 struct DLL_LINKAGE SThievesGuildInfo
 {
@@ -173,6 +175,8 @@ public:
 	void giveHeroArtifact(CGHeroInstance *h, ArtifactID aid);
 
 	void apply(CPack *pack);
+	/// Checksum of all packs applied on this game state, used to detect desynchronization
+	const CStateDigest & getStateDigest() const;
 	BFieldType battleGetBattlefieldType(int3 tile, CRandomGenerator & rand);
 	UpgradeInfo getUpgradeInfo(const CStackInstance &stack);
 	PlayerRelations::PlayerRelations getPlayerRelations(PlayerColor color1, PlayerColor color2);
@@ -218,6 +222,8 @@ public:
 		h & map;
 		h & players;
 		h & teams;
+		if(!h.saving)
+			checkFogOfWar();
 		h & hpool;
 		h & globalEffects;
 		h & rand;
@@ -274,6 +280,7 @@ private:
 	void initHeroes();
 	void giveCampaignBonusToHero(CGHeroInstance * hero);
 	void initFogOfWar();
+	void checkFogOfWar() const; //throws if fog of war of any team doesn't match size of map
 	void initStartingBonus();
 	void initTowns();
 	void initMapObjects();
@@ -297,6 +304,7 @@ private:
 
 	// ---- data -----
 	std::shared_ptr<CApplier<CBaseForGSApply>> applier;
+	std::unique_ptr<CStateDigest> stateDigest;
 	CRandomGenerator rand;
 
 	friend class CCallback;
@@ -304,4 +312,5 @@ private:
 	friend class IGameCallback;
 	friend class CMapHandler;
 	friend class CGameHandler;
+	template<typename T> friend class CApplyOnGS;
 };
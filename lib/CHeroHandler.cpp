@@ -14,6 +14,7 @@
 #include "filesystem/Filesystem.h"
 #include "VCMI_Lib.h"
 #include "JsonNode.h"
+#include "JsonView.h"
 #include "StringConstants.h"
 #include "battle/BattleHex.h"
 #include "CCreatureHandler.h"
@@ -744,26 +745,39 @@ void CHeroHandler::loadExperience()
 	expPerLevel.pop_back();//last value is broken
 }
 
+/// numbers of json vector converted to given type, same as JsonNode::convertTo
+template<typename T>
+static std::vector<T> convertNumbers(const JsonView & node)
+{
+	std::vector<T> ret;
+	for(size_t i = 0; i < node.size(); i++)
+		ret.push_back(T(static_cast<int>(node[i].Float())));
+	return ret;
+}
+
 void CHeroHandler::loadObstacles()
 {
-	auto loadObstacles = [](const JsonNode &node, bool absolute, std::map<int, CObstacleInfo> &out)
+	auto loadObstacles = [](const JsonView &node, bool absolute, std::map<int, CObstacleInfo> &out)
 	{
-		for(const JsonNode &obs : node.Vector())
+		for(size_t i = 0; i < node.size(); i++)
 		{
+			const JsonView obs = node[i];
 			int ID = static_cast<int>(obs["id"].Float());
 			CObstacleInfo & obi = out[ID];
 			obi.ID = ID;
-			obi.defName = obs["defname"].String();
+			obi.defName = obs["defname"].String().to_string();
 			obi.width =  static_cast<si32>(obs["width"].Float());
 			obi.height = static_cast<si32>(obs["height"].Float());
-			obi.allowedTerrains = obs["allowedTerrain"].convertTo<std::vector<ETerrainType> >();
-			obi.allowedSpecialBfields = obs["specialBattlefields"].convertTo<std::vector<BFieldType> >();
-			obi.blockedTiles = obs["blockedTiles"].convertTo<std::vector<si16> >();
+			obi.allowedTerrains = convertNumbers<ETerrainType>(obs["allowedTerrain"]);
+			obi.allowedSpecialBfields = convertNumbers<BFieldType>(obs["specialBattlefields"]);
+			obi.blockedTiles = convertNumbers<si16>(obs["blockedTiles"]);
 			obi.isAbsoluteObstacle = absolute;
 		}
 	};
 
-	const JsonNode config(ResourceID("config/obstacles.json"));
+	//read once at startup, parsed into compact tree without creating JsonNode
+	const JsonTree configTree(ResourceID("config/obstacles.json"));
+	const JsonView config = configTree.root();
 	loadObstacles(config["obstacles"], false, obstacles);
 	loadObstacles(config["absoluteObstacles"], true, absoluteObstacles);
 	//loadObstacles(config["moats"], true, moats);
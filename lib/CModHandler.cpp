@@ -24,6 +24,52 @@
 #include "IHandlerBase.h"
 #include "spells/CSpellHandler.h"
 #include "CSkillHandler.h"
+#include "VCMIDirs.h"
+#include "CThreadHelper.h"
+#include "serializer/BinarySerializer.h"
+#include "serializer/BinaryDeserializer.h"
+
+static const std::string CONTENT_CACHE_MAGIC = "VCMICCH";
+
+/// Runs tasks on all available cores, or on calling thread if there is nothing to gain
+static void runTasks(std::vector<Task> & tasks, bool parallel)
+{
+	const int threads = std::max<int>(1, boost::thread::hardware_concurrency());
+
+	if (!parallel || threads == 1 || tasks.size() < 2)
+	{
+		for(auto & task : tasks)
+			task();
+		return;
+	}
+
+	// exceptions can not leave worker threads, pass first of them to calling thread
+	boost::mutex mx;
+	std::exception_ptr error;
+	std::vector<Task> guardedTasks;
+	for(auto & task : tasks)
+	{
+		guardedTasks.push_back([&]()
+		{
+			try
+			{
+				task();
+			}
+			catch(...)
+			{
+				boost::unique_lock<boost::mutex> lock(mx);
+				if(!error)
+					error = std::current_exception();
+			}
+		});
+	}
+
+	CThreadHelper helper(&guardedTasks, std::min<int>(threads, guardedTasks.size()));
+	helper.run();
+
+	if(error)
+		std::rethrow_exception(error);
+}
 
 CIdentifierStorage::CIdentifierStorage():
 	state(LOADING)
@@ -301,7 +347,9 @@ void CIdentifierStorage::finalize()
 ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler, std::string objectName):
 	handler(handler),
 	objectName(objectName),
-	originalData(handler->loadLegacyData((size_t)VLC->modh->settings.data["textData"][objectName].Float()))
+	originalData(handler->loadLegacyData((size_t)VLC->modh->settings.data["textData"][objectName].Float())),
+	loadTime(0),
+	loadMemory(0)
 {
 	for(auto & node : originalData)
 	{
@@ -309,10 +357,8 @@ ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler, std::string objec
 	}
 }
 
-bool ContentTypeHandler::preloadModData(std::string modName, std::vector<std::string> fileList, bool validate)
+void ContentTypeHandler::preloadModData(std::string modName, JsonNode data)
 {
-	bool result;
-	JsonNode data = JsonUtils::assembleFromFiles(fileList, result);
 	data.setMeta(modName);
 
 	ModInfo & modInfo = modData[modName];
@@ -341,19 +387,23 @@ bool ContentTypeHandler::preloadModData(std::string modName, std::vector<std::st
 			JsonUtils::merge(remoteConf, entry.second);
 		}
 	}
-	return result;
 }
 
 bool ContentTypeHandler::loadMod(std::string modName, bool validate)
 {
+	auto start = std::chrono::steady_clock::now();
+	CMemoryWatch memory;
+
 	ModInfo & modInfo = modData[modName];
-	bool result = true;
 
-	auto performValidate = [&,this](JsonNode & data, const std::string & name){
-		handler->beforeValidate(data);
-		if (validate)
-			result &= JsonUtils::validate(data, "vcmi:" + objectName, name);
+	struct ObjectToLoad
+	{
+		const std::string * name;
+		JsonNode * data;
+		bool hasIndex;
+		size_t index;
 	};
+	std::vector<ObjectToLoad> objects;
 
 	// apply patches
 	if (!modInfo.patches.isNull())
@@ -380,29 +430,65 @@ bool ContentTypeHandler::loadMod(std::string modName, bool validate)
 			{
 				logMod->warn("no original data in loadMod(%s) at index %d", name, index);
 			}
-			performValidate(data, name);
-			handler->loadObject(modName, name, data, index);
+			objects.push_back({&name, &data, true, index});
 		}
 		else
 		{
 			// normal new object
 			logMod->trace("no index in loadMod(%s)", name);
-			performValidate(data,name);
-			handler->loadObject(modName, name, data);
+			objects.push_back({&name, &data, false, 0});
 		}
 	}
-	return result;
+
+	// beforeValidate only modifies given object, so all objects can be validated in parallel
+	std::vector<ui8> valid(objects.size(), true);
+	std::vector<Task> tasks;
+	for(size_t i = 0; i < objects.size(); i++)
+	{
+		tasks.push_back([&, i]()
+		{
+			handler->beforeValidate(*objects[i].data);
+			if (validate)
+				valid[i] = JsonUtils::validate(*objects[i].data, "vcmi:" + objectName, *objects[i].name);
+		});
+	}
+	runTasks(tasks, validate);
+
+	// objects must be loaded in order, identifiers depend on it
+	for(auto & object : objects)
+	{
+		if(object.hasIndex)
+			handler->loadObject(modName, *object.name, *object.data, object.index);
+		else
+			handler->loadObject(modName, *object.name, *object.data);
+	}
+
+	loadTime += std::chrono::steady_clock::now() - start;
+	loadMemory += memory.getDiff();
+	return !vstd::contains(valid, false);
 }
 
 
 void ContentTypeHandler::loadCustom()
 {
+	auto start = std::chrono::steady_clock::now();
+	CMemoryWatch memory;
+
 	handler->loadCustom();
+
+	loadTime += std::chrono::steady_clock::now() - start;
+	loadMemory += memory.getDiff();
 }
 
 void ContentTypeHandler::afterLoadFinalization()
 {
+	auto start = std::chrono::steady_clock::now();
+	CMemoryWatch memory;
+
 	handler->afterLoadFinalization();
+
+	loadTime += std::chrono::steady_clock::now() - start;
+	loadMemory += memory.getDiff();
 }
 
 CContentHandler::CContentHandler()
@@ -424,16 +510,6 @@ void CContentHandler::init()
 	//TODO: any other types of moddables?
 }
 
-bool CContentHandler::preloadModData(std::string modName, JsonNode modConfig, bool validate)
-{
-	bool result = true;
-	for(auto & handler : handlers)
-	{
-		result &= handler.second.preloadModData(modName, modConfig[handler.first].convertTo<std::vector<std::string> >(), validate);
-	}
-	return result;
-}
-
 bool CContentHandler::loadMod(std::string modName, bool validate)
 {
 	bool result = true;
@@ -460,20 +536,62 @@ void CContentHandler::afterLoadFinalization()
 	}
 }
 
-void CContentHandler::preloadData(CModInfo & mod)
+void CContentHandler::preloadData(const std::vector<CModInfo *> & mods)
 {
-	bool validate = (mod.validation != CModInfo::PASSED);
+	struct ParsedFiles
+	{
+		JsonNode data;
+		bool valid;
+	};
+
+	// parsing and validation of independent files can be done in parallel, each task writes only into its own entry
+	std::vector<std::map<std::string, ParsedFiles>> parsed(mods.size());
+	std::vector<ui8> configValid(mods.size(), true);
+	std::vector<Task> tasks;
+
+	for(size_t i = 0; i < mods.size(); i++)
+	{
+		const CModInfo & mod = *mods[i];
 
-	// print message in format [<8-symbols checksum>] <modname>
-	logMod->info("\t\t[%08x]%s", mod.checksum, mod.name);
+		if (mod.validation != CModInfo::PASSED && mod.identifier != "core")
+		{
+			tasks.push_back([&, i]()
+			{
+				configValid[i] = JsonUtils::validate(mods[i]->config, "vcmi:mod", mods[i]->identifier);
+			});
+		}
+
+		for(auto & handler : handlers)
+		{
+			ParsedFiles & target = parsed[i][handler.first];
+			auto fileList = mod.config[handler.first].convertTo<std::vector<std::string> >();
+
+			tasks.push_back([&target, fileList]()
+			{
+				target.data = JsonUtils::assembleFromFiles(fileList, target.valid);
+			});
+		}
+	}
+	runTasks(tasks, true);
 
-	if (validate && mod.identifier != "core")
+	for(size_t i = 0; i < mods.size(); i++)
 	{
-		if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
+		CModInfo & mod = *mods[i];
+
+		// print message in format [<8-symbols checksum>] <modname>
+		logMod->info("\t\t[%08x]%s", mod.checksum, mod.name);
+
+		if (!configValid[i])
 			mod.validation = CModInfo::FAILED;
+
+		for(auto & handler : handlers)
+		{
+			ParsedFiles & files = parsed[i][handler.first];
+			handler.second.preloadModData(mod.identifier, std::move(files.data));
+			if (!files.valid)
+				mod.validation = CModInfo::FAILED;
+		}
 	}
-	if (!preloadModData(mod.identifier, mod.config, validate))
-		mod.validation = CModInfo::FAILED;
 }
 
 void CContentHandler::load(CModInfo & mod)
@@ -494,6 +612,89 @@ void CContentHandler::load(CModInfo & mod)
 		logMod->info("\t\t[SKIP] %s", mod.name);
 }
 
+bool CContentHandler::loadCache(const boost::filesystem::path & file, const JsonNode & key)
+{
+	if(!boost::filesystem::exists(file))
+		return false;
+
+	try
+	{
+		CLoadFile cache(file);
+		cache.checkMagicBytes(CONTENT_CACHE_MAGIC);
+
+		JsonNode cachedKey;
+		cache >> cachedKey;
+		if(cachedKey != key)
+		{
+			logMod->info("\tContent cache is outdated");
+			return false;
+		}
+
+		ui32 handlersCount = 0;
+		cache >> handlersCount;
+
+		std::map<std::string, std::map<std::string, ContentTypeHandler::ModInfo>> cachedData;
+		for(ui32 i = 0; i < handlersCount; i++)
+		{
+			std::string name;
+			cache >> name;
+			if(!vstd::contains(handlers, name))
+				return false;
+			cache >> cachedData[name];
+		}
+
+		if(cachedData.size() != handlers.size())
+			return false;
+
+		for(auto & handler : handlers)
+			handler.second.modData.swap(cachedData[handler.first]);
+		return true;
+	}
+	catch(std::exception & e)
+	{
+		logMod->warn("Failed to load content cache %s: %s", file.string(), e.what());
+		return false;
+	}
+}
+
+void CContentHandler::saveCache(const boost::filesystem::path & file, const JsonNode & key) const
+{
+	//several processes may start at once, write to temporary file and replace cache in one step
+	auto tempFile = file;
+	tempFile += boost::filesystem::unique_path(".%%%%-%%%%").string();
+
+	try
+	{
+		{
+			CSaveFile cache(tempFile);
+			cache.putMagicBytes(CONTENT_CACHE_MAGIC);
+			cache << key;
+			cache << static_cast<ui32>(handlers.size());
+			for(auto & handler : handlers)
+			{
+				cache << handler.first;
+				cache << handler.second.modData;
+			}
+		}
+		boost::filesystem::rename(tempFile, file);
+	}
+	catch(std::exception & e)
+	{
+		logMod->warn("Failed to save content cache %s: %s", file.string(), e.what());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempFile, ec);
+	}
+}
+
+void CContentHandler::logLoadingStatistics() const
+{
+	for(auto & handler : handlers)
+	{
+		auto time = std::chrono::duration_cast<std::chrono::milliseconds>(handler.second.loadTime).count();
+		logMod->info("\t\t %s: %d ms, %d KB", handler.first, time, handler.second.loadMemory);
+	}
+}
+
 const ContentTypeHandler & CContentHandler::operator[](const std::string & name) const
 {
 	return handlers.at(name);
@@ -926,6 +1127,10 @@ void CModHandler::loadModFilesystems()
 		CModInfo & mod = allMods[modName];
 		CResourceHandler::addFilesystem("data", modName, genModFilesystem(modName, mod.config));
 	}
+
+	auto root = dynamic_cast<const CFilesystemList *>(CResourceHandler::get());
+	if(root)
+		logMod->debug("Resource index uses %d KB", root->getIndexMemoryUsage() / 1024);
 }
 
 CModInfo & CModHandler::getModData(TModID modId)
@@ -942,6 +1147,38 @@ CModInfo & CModHandler::getModData(TModID modId)
 	}
 }
 
+JsonNode CModHandler::getContentCacheKey() const
+{
+	JsonNode key;
+	key["version"].String() = GameConstants::VCMI_VERSION;
+
+	auto addMod = [&](const CModInfo & mod)
+	{
+		JsonNode entry;
+		entry["id"].String() = mod.identifier;
+		entry["checksum"].Float() = mod.checksum;
+		key["mods"].Vector().push_back(entry);
+	};
+
+	addMod(coreMod);
+	for(const TModID & modName : activeMods)
+		addMod(allMods.at(modName));
+	return key;
+}
+
+bool CModHandler::canUseContentCache() const
+{
+	if(coreMod.validation != CModInfo::PASSED)
+		return false;
+
+	for(const TModID & modName : activeMods)
+	{
+		if(allMods.at(modName).validation != CModInfo::PASSED)
+			return false;
+	}
+	return true;
+}
+
 void CModHandler::initializeConfig()
 {
 	loadConfigFromFile("defaultMods.json");
@@ -961,12 +1198,30 @@ void CModHandler::load()
 		allMods[modName].updateChecksum(calculateModChecksum(modName, CResourceHandler::get(modName)));
 	}
 
-	// first - load virtual "core" mod that contains all data
-	// TODO? move all data into real mods? RoE, AB, SoD, WoG
-	content->preloadData(coreMod);
-	for(const TModID & modName : activeMods)
-		content->preloadData(allMods[modName]);
-	logMod->info("\tParsing mod data: %d ms", timer.getDiff());
+	const auto cacheFile = VCMIDirs::get().userCachePath() / "contentCache.vcache";
+	const JsonNode cacheKey = getContentCacheKey();
+
+	if(canUseContentCache() && content->loadCache(cacheFile, cacheKey))
+	{
+		logMod->info("\tLoading mod data from cache: %d ms", timer.getDiff());
+	}
+	else
+	{
+		// first - load virtual "core" mod that contains all data
+		// TODO? move all data into real mods? RoE, AB, SoD, WoG
+		std::vector<CModInfo *> mods = {&coreMod};
+		for(const TModID & modName : activeMods)
+			mods.push_back(&allMods[modName]);
+		content->preloadData(mods);
+		logMod->info("\tParsing mod data: %d ms", timer.getDiff());
+
+		bool failed = coreMod.validation == CModInfo::FAILED;
+		for(const TModID & modName : activeMods)
+			failed |= allMods[modName].validation == CModInfo::FAILED;
+
+		if(!failed)
+			content->saveCache(cacheFile, cacheKey);
+	}
 
 	content->load(coreMod);
 	for(const TModID & modName : activeMods)
@@ -984,6 +1239,8 @@ void CModHandler::load()
 
 	content->afterLoadFinalization();
 	logMod->info("\tHandlers post-load finalization: %d ms ", timer.getDiff());
+
+	content->logLoadingStatistics();
 	logMod->info("\tAll game content loaded in %d ms", totalTime.getDiff());
 }
 
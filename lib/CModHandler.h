@@ -118,6 +118,12 @@ public:
 		JsonNode modData;
 		/// mod data for this mod from other mods (patches)
 		JsonNode patches;
+
+		template <typename Handler> void serialize(Handler &h, const int version)
+		{
+			h & modData;
+			h & patches;
+		}
 	};
 	/// handler to which all data will be loaded
 	IHandlerBase * handler;
@@ -127,11 +133,15 @@ public:
 	std::vector<JsonNode> originalData;
 	std::map<std::string, ModInfo> modData;
 
+	/// time and resident memory spent on loading objects into handler, for statistics
+	std::chrono::steady_clock::duration loadTime;
+	si64 loadMemory;
+
 	ContentTypeHandler(IHandlerBase * handler, std::string objectName);
 
 	/// local version of methods in ContentHandler
 	/// returns true if loading was successful
-	bool preloadModData(std::string modName, std::vector<std::string> fileList, bool validate);
+	void preloadModData(std::string modName, JsonNode data);
 	bool loadMod(std::string modName, bool validate);
 	void loadCustom();
 	void afterLoadFinalization();
@@ -140,9 +150,6 @@ public:
 /// class used to load all game data into handlers. Used only during loading
 class DLL_LINKAGE CContentHandler
 {
-	/// preloads all data from fileList as data from modName.
-	bool preloadModData(std::string modName, JsonNode modConfig, bool validate);
-
 	/// actually loads data in mod
 	bool loadMod(std::string modName, bool validate);
 
@@ -152,17 +159,26 @@ public:
 
 	void init();
 
-	/// preloads all data from fileList as data from modName.
-	void preloadData(CModInfo & mod);
+	/// preloads all data of given mods. Files are parsed in parallel, but preloaded in order of mods in list
+	void preloadData(const std::vector<CModInfo *> & mods);
 
 	/// actually loads data in mod
 	void load(CModInfo & mod);
 
+	/// replaces preloadData() for all mods with data stored in binary cache
+	/// returns false if cache does not exists or was created for different set of mods
+	bool loadCache(const boost::filesystem::path & file, const JsonNode & key);
+	/// stores data of all preloaded mods into binary cache, key identifies set of mods
+	void saveCache(const boost::filesystem::path & file, const JsonNode & key) const;
+
 	void loadCustom();
 
 	/// all data was loaded, time for final validation / integration
 	void afterLoadFinalization();
 
+	/// prints time and memory spent on loading of each data type
+	void logLoadingStatistics() const;
+
 	const ContentTypeHandler & operator[] (const std::string & name) const;
 };
 
@@ -255,6 +271,9 @@ class DLL_LINKAGE CModHandler
 	std::vector<std::string> getModList(std::string path);
 	void loadMods(std::string path, std::string parent, const JsonNode & modSettings, bool enableMods);
 	void loadOneMod(std::string modName, std::string parent, const JsonNode & modSettings, bool enableMods);
+
+	/// cache can be used only if all mods have already passed validation
+	bool canUseContentCache() const;
 public:
 
 	CIdentifierStorage identifiers;
@@ -272,6 +291,10 @@ public:
 	std::vector<std::string> getAllMods();
 	std::vector<std::string> getActiveMods();
 
+	/// identifies VCMI version, active mods and their content by checksums.
+	/// Data cached on disk that depends on loaded mods can be used only if key has not changed
+	JsonNode getContentCacheKey() const;
+
 	/// load content from all available mods
 	void load();
 	void afterLoad(bool onlyEssential);
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "HeroBonus.h"
+#include "mapping/CTileSet.h"
 
 class CGHeroInstance;
 class CGTownInstance;
@@ -72,17 +73,30 @@ struct DLL_LINKAGE TeamState : public CBonusSystemNode
 public:
 	TeamID id; //position in gameState::teams
 	std::set<PlayerColor> players; // members of this team
-	//TODO: boost::array, bool if possible
-	std::vector<std::vector<std::vector<ui8> > >  fogOfWarMap; //true - visible, false - hidden
+	CTileSet fogOfWarMap; //tiles visible for team
 
 	TeamState();
 	TeamState(TeamState && other);
 
+private:
+	void loadOldFogOfWarMap(const std::vector<std::vector<std::vector<ui8> > > & oldFogOfWarMap);
+
+public:
+
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
 		h & id;
 		h & players;
-		h & fogOfWarMap;
+		if(version >= 797)
+		{
+			h & fogOfWarMap;
+		}
+		else
+		{
+			std::vector<std::vector<std::vector<ui8> > > oldFogOfWarMap; //[x][y][z], loading only
+			h & oldFogOfWarMap;
+			loadOldFogOfWarMap(oldFogOfWarMap);
+		}
 		h & static_cast<CBonusSystemNode&>(*this);
 	}
 
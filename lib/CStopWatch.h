@@ -62,3 +62,47 @@ private:
 	#endif
 	}
 };
+
+/// Measures changes of resident memory of process, in KB. Always reports zero where /proc filesystem is not available
+class CMemoryWatch
+{
+	si64 last;
+
+public:
+	CMemoryWatch()
+		: last(current())
+	{
+	}
+
+	si64 getDiff() //get diff in KB
+	{
+		si64 now = current();
+		si64 ret = now - last;
+		last = now;
+		return ret;
+	}
+
+	static si64 current()
+	{
+		return readStatus("VmRSS:");
+	}
+
+	/// highest resident memory of process so far, in KB
+	static si64 peak()
+	{
+		return readStatus("VmHWM:");
+	}
+
+private:
+	static si64 readStatus(const std::string & key)
+	{
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while(std::getline(status, line))
+		{
+			if(boost::algorithm::starts_with(line, key))
+				return std::atoll(line.c_str() + key.size());
+		}
+		return 0;
+	}
+};
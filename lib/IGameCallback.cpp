@@ -21,12 +21,14 @@
 #include "serializer/BinaryDeserializer.h"
 #include "serializer/BinarySerializer.h"
 #include "serializer/CLoadIntegrityValidator.h"
+#include "serializer/CPackJournal.h"
 #include "rmg/CMapGenOptions.h"
 #include "mapping/CCampaignHandler.h"
 #include "mapObjects/CObjectClassesHandler.h"
 #include "StartInfo.h"
 #include "CGameState.h"
 #include "mapping/CMap.h"
+#include "mapping/CTileSet.h"
 #include "CPlayerState.h"
 #include "CSkillHandler.h"
 
@@ -55,7 +57,25 @@ void CPrivilegedInfoCallback::getFreeTiles(std::vector<int3> & tiles) const
 	}
 }
 
+static void addTiles(CTileSet & tiles, const CTileSet & added)
+{
+	if(tiles.getMapSize() != added.getMapSize()) //default-constructed set, size of map was not known
+	{
+		assert(tiles.empty());
+		tiles = added;
+	}
+	else
+		tiles |= added;
+}
+
 void CPrivilegedInfoCallback::getTilesInRange(std::unordered_set<int3, ShashInt3> & tiles, int3 pos, int radious, boost::optional<PlayerColor> player, int mode, int3::EDistanceFormula distanceFormula) const
+{
+	CTileSet result;
+	getTilesInRange(result, pos, radious, player, mode, distanceFormula);
+	tiles.insert(result.begin(), result.end());
+}
+
+void CPrivilegedInfoCallback::getTilesInRange(CTileSet & tiles, int3 pos, int radious, boost::optional<PlayerColor> player, int mode, int3::EDistanceFormula distanceFormula) const
 {
 	if(!!player && *player >= PlayerColor::PLAYER_LIMIT)
 	{
@@ -66,28 +86,37 @@ void CPrivilegedInfoCallback::getTilesInRange(std::unordered_set<int3, ShashInt3
 		getAllTiles (tiles, player, -1, 0);
 	else
 	{
-		const TeamState * team = !player ? nullptr : gs->getPlayerTeam(*player);
-		for (int xd = std::max<int>(pos.x - radious , 0); xd <= std::min<int>(pos.x + radious, gs->map->width - 1); xd++)
+		CTileSet range(int3(gs->map->width, gs->map->height, gs->map->twoLevel ? 2 : 1));
+		for (int yd = std::max<int>(pos.y - radious, 0); yd <= std::min<int>(pos.y + radious, gs->map->height - 1); yd++)
 		{
-			for (int yd = std::max<int>(pos.y - radious, 0); yd <= std::min<int>(pos.y + radious, gs->map->height - 1); yd++)
+			for (int xd = std::max<int>(pos.x - radious , 0); xd <= std::min<int>(pos.x + radious, gs->map->width - 1); xd++)
 			{
 				int3 tilePos(xd,yd,pos.z);
-				double distance = pos.dist(tilePos, distanceFormula);
-
-				if(distance <= radious)
-				{
-					if(!player
-						|| (mode == 1  && team->fogOfWarMap[xd][yd][pos.z]==0)
-						|| (mode == -1 && team->fogOfWarMap[xd][yd][pos.z]==1)
-					)
-						tiles.insert(int3(xd,yd,pos.z));
-				}
+				if(pos.dist(tilePos, distanceFormula) <= radious)
+					range.insert(tilePos);
 			}
 		}
+
+		if(player)
+		{
+			const TeamState * team = gs->getPlayerTeam(*player);
+			if(mode == 1)
+				range -= team->fogOfWarMap;
+			else if(mode == -1)
+				range &= team->fogOfWarMap;
+		}
+		addTiles(tiles, range);
 	}
 }
 
 void CPrivilegedInfoCallback::getAllTiles(std::unordered_set<int3, ShashInt3> & tiles, boost::optional<PlayerColor> Player, int level, int surface) const
+{
+	CTileSet result;
+	getAllTiles(result, Player, level, surface);
+	tiles.insert(result.begin(), result.end());
+}
+
+void CPrivilegedInfoCallback::getAllTiles(CTileSet & tiles, boost::optional<PlayerColor> Player, int level, int surface) const
 {
 	if(!!Player && *Player >= PlayerColor::PLAYER_LIMIT)
 	{
@@ -108,19 +137,20 @@ void CPrivilegedInfoCallback::getAllTiles(std::unordered_set<int3, ShashInt3> &
 	else
 		floors.push_back(level);
 
+	CTileSet result(int3(gs->map->width, gs->map->height, gs->map->twoLevel ? 2 : 1));
 	for (auto zd : floors)
 	{
-
-		for (int xd = 0; xd < gs->map->width; xd++)
+		for (int yd = 0; yd < gs->map->height; yd++)
 		{
-			for (int yd = 0; yd < gs->map->height; yd++)
+			for (int xd = 0; xd < gs->map->width; xd++)
 			{
 				if ((getTile (int3 (xd,yd,zd))->terType == ETerrainType::WATER && water)
 					|| (getTile (int3 (xd,yd,zd))->terType != ETerrainType::WATER && land))
-					tiles.insert(int3(xd,yd,zd));
+					result.insert(int3(xd,yd,zd));
 			}
 		}
 	}
+	addTiles(tiles, result);
 }
 
 void CPrivilegedInfoCallback::pickAllowedArtsSet(std::vector<const CArtifact *> & out, CRandomGenerator & rand)
@@ -151,8 +181,28 @@ CGameState * CPrivilegedInfoCallback::gameState()
 	return gs;
 }
 
+namespace ESaveKind
+{
+	enum ESaveKind : ui8
+	{
+		FULL, //contains VLC and game state
+		DELTA, //server part of delta save, contains packs applied after checkpoint
+		DELTA_CLIENT //client part of delta save, game state is restored from server part
+	};
+}
+
+static boost::filesystem::path getLoadedFileName(const CLoadFile & in)
+{
+	return in.fName;
+}
+
+static boost::filesystem::path getLoadedFileName(const CLoadIntegrityValidator & in)
+{
+	return in.primaryFile->fName;
+}
+
 template<typename Loader>
-void CPrivilegedInfoCallback::loadCommonState(Loader & in)
+void CPrivilegedInfoCallback::loadCommonState(Loader & in, const SaveCheckpoint * expectedCheckpoint)
 {
 	logGlobal->info("Loading lib part of game...");
 	in.checkMagicBytes(SAVEGAME_MAGIC);
@@ -166,15 +216,55 @@ void CPrivilegedInfoCallback::loadCommonState(Loader & in)
 	logGlobal->info("\tReading options");
 	in.serializer & si;
 
-	logGlobal->info("\tReading handlers");
-	in.serializer & *VLC;
+	ui8 saveKind = ESaveKind::FULL;
+	SaveCheckpoint checkpoint;
+	if(in.serializer.fileVersion >= 795)
+	{
+		in.serializer & saveKind;
+		in.serializer & checkpoint;
+	}
+
+	if(expectedCheckpoint && (saveKind != ESaveKind::FULL || checkpoint.token != expectedCheckpoint->token))
+		throw std::runtime_error("Checkpoint " + expectedCheckpoint->name + " was overwritten, delta save cannot be restored!");
 
-	logGlobal->info("\tReading gamestate");
-	in.serializer & gs;
+	if(saveKind == ESaveKind::FULL)
+	{
+		logGlobal->info("\tReading handlers");
+		in.serializer & *VLC;
+
+		logGlobal->info("\tReading gamestate");
+		in.serializer & gs;
+		return;
+	}
+
+	if(saveKind == ESaveKind::DELTA)
+	{
+		CPackJournal journal;
+		in.serializer & journal;
+
+		boost::filesystem::path fname = getLoadedFileName(in);
+		boost::filesystem::path checkpointName = CSaveCheckpoints::getPath(fname.parent_path(), checkpoint, fname.extension().string());
+
+		logGlobal->info("\tReading checkpoint %s", checkpointName.string());
+		CLoadFile checkpointFile(checkpointName, MINIMAL_SERIALIZATION_VERSION);
+		loadCommonState(checkpointFile, &checkpoint);
+
+		logGlobal->info("\tReplaying %d packs", journal.size());
+		journal.replay(gs);
+	}
+	else if(!gs)
+	{
+		throw std::runtime_error("Client part of delta save can be loaded only after server part!");
+	}
+
+	//remaining data refers to game objects that were not stored in this file
+	in.serializer.smartPointerSerialization = false;
+	in.sendStackInstanceByIds = true;
+	in.addStdVecItems(gs);
 }
 
 template<typename Saver>
-void CPrivilegedInfoCallback::saveCommonState(Saver & out) const
+void CPrivilegedInfoCallback::saveCommonState(Saver & out, const SaveCheckpoint & checkpoint) const
 {
 	logGlobal->info("Saving lib part of game...");
 	out.putMagicBytes(SAVEGAME_MAGIC);
@@ -182,16 +272,64 @@ void CPrivilegedInfoCallback::saveCommonState(Saver & out) const
 	out.serializer & static_cast<CMapHeader&>(*gs->map);
 	logGlobal->info("\tSaving options");
 	out.serializer & gs->scenarioOps;
+	ui8 saveKind = ESaveKind::FULL;
+	out.serializer & saveKind;
+	out.serializer & checkpoint;
 	logGlobal->info("\tSaving handlers");
 	out.serializer & *VLC;
 	logGlobal->info("\tSaving gamestate");
 	out.serializer & gs;
 }
 
+template<typename Saver>
+void CPrivilegedInfoCallback::saveCommonStateDelta(Saver & out, const SaveCheckpoint & checkpoint, const CPackJournal * journal) const
+{
+	logGlobal->info("Saving lib part of game as delta of %s...", checkpoint.name);
+	out.putMagicBytes(SAVEGAME_MAGIC);
+	logGlobal->info("\tSaving header");
+	out.serializer & static_cast<CMapHeader&>(*gs->map);
+	logGlobal->info("\tSaving options");
+	out.serializer & gs->scenarioOps;
+	ui8 saveKind = journal ? ESaveKind::DELTA : ESaveKind::DELTA_CLIENT;
+	out.serializer & saveKind;
+	out.serializer & checkpoint;
+	if(journal)
+	{
+		logGlobal->info("\tSaving %d packs", journal->size());
+		out.serializer & *journal;
+	}
+
+	out.serializer.smartPointerSerialization = false;
+	out.sendStackInstanceByIds = true;
+	out.addStdVecItems(gs);
+}
+
+bool CPrivilegedInfoCallback::isDeltaSave(const boost::filesystem::path & fname)
+{
+	return !getDeltaCheckpointName(fname).empty();
+}
+
+std::string CPrivilegedInfoCallback::getDeltaCheckpointName(const boost::filesystem::path & fname)
+{
+	CLoadFile lf(fname, MINIMAL_SERIALIZATION_VERSION);
+	lf.checkMagicBytes(SAVEGAME_MAGIC);
+
+	if(lf.serializer.fileVersion < 795)
+		return "";
+
+	CMapHeader header;
+	std::unique_ptr<StartInfo> si;
+	ui8 saveKind = ESaveKind::FULL;
+	SaveCheckpoint checkpoint;
+	lf >> header >> si >> saveKind >> checkpoint;
+	return saveKind != ESaveKind::FULL ? checkpoint.name : "";
+}
+
 // hardly memory usage for `-gdwarf-4` flag
-template DLL_LINKAGE void CPrivilegedInfoCallback::loadCommonState<CLoadIntegrityValidator>(CLoadIntegrityValidator &);
-template DLL_LINKAGE void CPrivilegedInfoCallback::loadCommonState<CLoadFile>(CLoadFile &);
-template DLL_LINKAGE void CPrivilegedInfoCallback::saveCommonState<CSaveFile>(CSaveFile &) const;
+template DLL_LINKAGE void CPrivilegedInfoCallback::loadCommonState<CLoadIntegrityValidator>(CLoadIntegrityValidator &, const SaveCheckpoint *);
+template DLL_LINKAGE void CPrivilegedInfoCallback::loadCommonState<CLoadFile>(CLoadFile &, const SaveCheckpoint *);
+template DLL_LINKAGE void CPrivilegedInfoCallback::saveCommonState<CSaveFile>(CSaveFile &, const SaveCheckpoint &) const;
+template DLL_LINKAGE void CPrivilegedInfoCallback::saveCommonStateDelta<CSaveFile>(CSaveFile &, const SaveCheckpoint &, const CPackJournal *) const;
 
 TerrainTile * CNonConstInfoCallback::getTile( int3 pos )
 {
@@ -22,7 +22,10 @@ struct StackLocation;
 struct ArtifactLocation;
 class CCreatureSet;
 class CStackBasicDescriptor;
+class CPackJournal;
+struct SaveCheckpoint;
 class CGCreature;
+class CTileSet;
 struct ShashInt3;
 
 class DLL_LINKAGE CPrivilegedInfoCallback : public CGameInfoCallback
@@ -32,14 +35,23 @@ public:
 	void getFreeTiles (std::vector<int3> &tiles) const; //used for random spawns
 	void getTilesInRange(std::unordered_set<int3, ShashInt3> &tiles, int3 pos, int radious, boost::optional<PlayerColor> player = boost::optional<PlayerColor>(), int mode = 0, int3::EDistanceFormula formula = int3::DIST_2D) const; //mode 1 - only unrevealed tiles; mode 0 - all, mode -1 -  only revealed
 	void getAllTiles (std::unordered_set<int3, ShashInt3> &tiles, boost::optional<PlayerColor> player = boost::optional<PlayerColor>(), int level=-1, int surface=0) const; //returns all tiles on given level (-1 - both levels, otherwise number of level); surface: 0 - land and water, 1 - only land, 2 - only water
+	/// same as above, tiles are added to bitmap of whole map and filtered by fog of war with word-wide operations
+	void getTilesInRange(CTileSet &tiles, int3 pos, int radious, boost::optional<PlayerColor> player = boost::optional<PlayerColor>(), int mode = 0, int3::EDistanceFormula formula = int3::DIST_2D) const;
+	void getAllTiles (CTileSet &tiles, boost::optional<PlayerColor> player = boost::optional<PlayerColor>(), int level=-1, int surface=0) const;
 	void pickAllowedArtsSet(std::vector<const CArtifact*> &out, CRandomGenerator & rand); //gives 3 treasures, 3 minors, 1 major -> used by Black Market and Artifact Merchant
 	void getAllowedSpells(std::vector<SpellID> &out, ui16 level);
 
 	template<typename Saver>
-	void saveCommonState(Saver &out) const; //stores GS and VLC
+	void saveCommonState(Saver &out, const SaveCheckpoint & checkpoint) const; //stores GS and VLC, marks save as checkpoint for delta saves
+
+	template<typename Saver>
+	void saveCommonStateDelta(Saver &out, const SaveCheckpoint & checkpoint, const CPackJournal * journal) const; //stores checkpoint reference and packs applied since it, journal is null for client part of save
 
 	template<typename Loader>
-	void loadCommonState(Loader &in); //loads GS and VLC
+	void loadCommonState(Loader &in, const SaveCheckpoint * expectedCheckpoint = nullptr); //loads GS and VLC, or restores them from checkpoint for delta saves
+
+	static bool isDeltaSave(const boost::filesystem::path & fname);
+	static std::string getDeltaCheckpointName(const boost::filesystem::path & fname); //empty for full saves
 };
 
 class DLL_LINKAGE IGameEventCallback : public IGameEventRealizer
@@ -95,7 +107,7 @@ public:
 	virtual void sendAndApply(CPackForClient * pack) = 0;
 	virtual void heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)=0; //when two heroes meet on adventure map
 	virtual void changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide) = 0;
-	virtual void changeFogOfWar(std::unordered_set<int3, ShashInt3> &tiles, PlayerColor player, bool hide) = 0;
+	virtual void changeFogOfWar(const CTileSet &tiles, PlayerColor player, bool hide) = 0;
 };
 
 class DLL_LINKAGE CNonConstInfoCallback : public CPrivilegedInfoCallback
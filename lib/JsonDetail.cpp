@@ -149,18 +149,54 @@ JsonWriter::JsonWriter(std::ostream & output, bool compact)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+	// Parser skips long runs of ordinary characters by 8-byte blocks: all bytes of block are tested at once
+	// and only block that contains something interesting is processed character by character.
+	// All tests below are exact and do not depend on byte order
+	const ui64 ONES  = 0x0101010101010101ull;
+	const ui64 HIGHS = 0x8080808080808080ull;
+	const ui64 LOWS  = 0x7F7F7F7F7F7F7F7Full;
+
+	inline ui64 loadBlock(const char * data)
+	{
+		ui64 block;
+		std::memcpy(&block, data, sizeof(block));
+		return block;
+	}
+
+	/// high bit is set in every byte of block that is equal to value
+	inline ui64 bytesEqual(ui64 block, ui8 value)
+	{
+		block ^= ONES * value;
+		return ~(((block & LOWS) + LOWS) | block | LOWS);
+	}
+
+	/// high bit is set in every byte of block that is less than value, value must be in range 1..128
+	inline ui64 bytesLess(ui64 block, ui8 value)
+	{
+		return ~(((block & LOWS) + ONES * (0x80 - value)) | block) & HIGHS;
+	}
+
+	/// number of bytes marked in result of one of functions above
+	inline ui32 countBytes(ui64 mask)
+	{
+		return static_cast<ui32>((((mask >> 7) * ONES) >> 56) & 0xFF);
+	}
+}
+
 JsonParser::JsonParser(const char * inputString, size_t stringSize):
 	input(inputString, stringSize),
 	lineCount(1),
 	lineStart(0),
-	pos(0)
+	pos(0),
+	tree(nullptr)
 {
 }
 
-JsonNode JsonParser::parse(std::string fileName)
+template<typename Root>
+void JsonParser::parseRoot(Root &root, const std::string &fileName)
 {
-	JsonNode root;
-
 	if (input.size() == 0)
 	{
 		error("File is empty", false);
@@ -183,9 +219,62 @@ JsonNode JsonParser::parse(std::string fileName)
 		logMod->warn("File %s is not a valid JSON file!", fileName);
 		logMod->warn(errors);
 	}
+}
+
+JsonNode JsonParser::parse(std::string fileName)
+{
+	JsonNode root;
+	parseRoot(root, fileName);
 	return root;
 }
 
+void JsonParser::parse(std::string fileName, JsonTree &result)
+{
+	tree = &result;
+
+	JsonTree::Node root = JsonTree::Node();
+	parseRoot(root, fileName);
+	assert(pending.empty());
+
+	result.rootIndex = static_cast<ui32>(result.nodes.size());
+	result.nodes.push_back(root);
+	result.nodeKeys.push_back(0);
+
+	// keys were interned in order of appearance, renumber them so order of indexes is the same as order of keys
+	std::vector<ui32> order(result.keys.size());
+	for (ui32 i = 0; i < order.size(); i++)
+		order[i] = i;
+	boost::sort(order, [&](ui32 left, ui32 right)
+	{
+		return result.keys[left] < result.keys[right];
+	});
+
+	std::vector<std::string> sortedKeys;
+	std::vector<ui32> renumbered(order.size());
+	sortedKeys.reserve(order.size());
+	for (ui32 i = 0; i < order.size(); i++)
+	{
+		renumbered[order[i]] = i;
+		sortedKeys.push_back(std::move(result.keys[order[i]]));
+	}
+	result.keys.swap(sortedKeys);
+
+	if (!renumbered.empty())
+	{
+		for (auto & key : result.nodeKeys)
+			key = renumbered[key];
+	}
+	result.keyIndexes.clear();
+	for (ui32 i = 0; i < result.keys.size(); i++)
+		result.keyIndexes[result.keys[i]] = i;
+
+	// parsed text has no meta
+	result.metas.assign(1, std::string());
+	result.nodeMeta.assign(result.nodes.size(), 0);
+
+	tree = nullptr;
+}
+
 bool JsonParser::isValid()
 {
 	return errors.empty();
@@ -230,6 +319,25 @@ bool JsonParser::extractWhitespace(bool verbose)
 {
 	while (true)
 	{
+		while (pos + sizeof(ui64) <= input.size())
+		{
+			ui64 block = loadBlock(&input[pos]);
+			if (bytesLess(block, ' ' + 1) != HIGHS)
+				break; // end of whitespace is somewhere in this block
+
+			ui64 newlines = bytesEqual(block, '\n');
+			if (newlines)
+			{
+				size_t lastNewline = pos + sizeof(ui64) - 1;
+				while (input[lastNewline] != '\n')
+					lastNewline--;
+
+				lineCount += countBytes(newlines);
+				lineStart = lastNewline + 1;
+			}
+			pos += sizeof(ui64);
+		}
+
 		while (pos < input.size() && (ui8)input[pos] <= ' ')
 		{
 			if (input[pos] == '\n')
@@ -250,8 +358,11 @@ bool JsonParser::extractWhitespace(bool verbose)
 		else
 			error("Comments must consist from two slashes!", true);
 
-		while (pos < input.size() && input[pos] != '\n')
-			pos++;
+		if (pos < input.size())
+		{
+			auto lineEnd = static_cast<const char *>(std::memchr(&input[pos], '\n', input.size() - pos));
+			pos = lineEnd ? lineEnd - &input[0] : input.size();
+		}
 	}
 
 	if (pos >= input.size() && verbose)
@@ -286,6 +397,17 @@ bool JsonParser::extractString(std::string &str)
 
 	while (pos != input.size())
 	{
+		// skip blocks without quotes, escapes and control characters
+		while (pos + sizeof(ui64) <= input.size())
+		{
+			ui64 block = loadBlock(&input[pos]);
+			if (bytesEqual(block, '\"') | bytesEqual(block, '\\') | bytesLess(block, ' '))
+				break;
+			pos += sizeof(ui64);
+		}
+		if (pos == input.size())
+			break;
+
 		if (input[pos] == '\"') // Correct end of string
 		{
 			str.append( &input[first], pos-first);
@@ -324,7 +446,7 @@ bool JsonParser::extractString(JsonNode &node)
 		return false;
 
 	node.setType(JsonNode::JsonType::DATA_STRING);
-	node.String() = str;
+	node.String() = std::move(str);
 	return true;
 }
 
@@ -393,30 +515,24 @@ bool JsonParser::extractStruct(JsonNode &node)
 		if (!extractString(key))
 			return false;
 
-		// split key string into actual key and meta-flags
-		std::vector<std::string> keyAndFlags;
-		boost::split(keyAndFlags, key, boost::is_any_of("#"));
-		key = keyAndFlags[0];
-		// check for unknown flags - helps with debugging
-		std::vector<std::string> knownFlags = { "override" };
-		for(int i = 1; i < keyAndFlags.size(); i++)
-		{
-			if(!vstd::contains(knownFlags, keyAndFlags[i]))
-				error("Encountered unknown flag #" + keyAndFlags[i], true);
-		}
+		std::vector<std::string> keyFlags;
+		extractKeyFlags(key, keyFlags);
 
-		if (node.Struct().find(key) != node.Struct().end())
+		auto position = node.Struct().lower_bound(key);
+		bool duplicated = position != node.Struct().end() && position->first == key;
+		if (duplicated)
 			error("Dublicated element encountered!", true);
 
 		if (!extractSeparator())
 			return false;
 
-		if (!extractElement(node.Struct()[key], '}'))
+		JsonNode & element = duplicated ? position->second : node.Struct().emplace_hint(position, std::move(key), JsonNode())->second;
+
+		if (!extractElement(element, '}'))
 			return false;
 
 		// flags from key string belong to referenced element
-		for(int i = 1; i < keyAndFlags.size(); i++)
-			node.Struct()[key].flags.push_back(keyAndFlags[i]);
+		vstd::concatenate(element.flags, keyFlags);
 
 		if (input[pos] == '}')
 		{
@@ -443,9 +559,7 @@ bool JsonParser::extractArray(JsonNode &node)
 
 	while (true)
 	{
-		//NOTE: currently 50% of time is this vector resizing.
-		//May be useful to use list during parsing and then swap() all items to vector
-		node.Vector().resize(node.Vector().size()+1);
+		node.Vector().emplace_back();
 
 		if (!extractElement(node.Vector().back(), ']'))
 			return false;
@@ -458,11 +572,34 @@ bool JsonParser::extractArray(JsonNode &node)
 	}
 }
 
+void JsonParser::extractKeyFlags(std::string &key, std::vector<std::string> &flags)
+{
+	// split key string into actual key and meta-flags
+	if (key.find('#') == std::string::npos)
+		return;
+
+	boost::split(flags, key, boost::is_any_of("#"));
+	key = flags[0];
+	flags.erase(flags.begin());
+	// check for unknown flags - helps with debugging
+	static const std::vector<std::string> knownFlags = { "override" };
+	for(auto & flag : flags)
+	{
+		if(!vstd::contains(knownFlags, flag))
+			error("Encountered unknown flag #" + flag, true);
+	}
+}
+
 bool JsonParser::extractElement(JsonNode &node, char terminator)
 {
 	if (!extractValue(node))
 		return false;
 
+	return extractElementEnd(terminator);
+}
+
+bool JsonParser::extractElementEnd(char terminator)
+{
 	if (!extractWhitespace())
 		return false;
 
@@ -584,6 +721,193 @@ bool JsonParser::extractFloat(JsonNode &node)
 	return true;
 }
 
+bool JsonParser::extractValue(JsonTree::Node &node)
+{
+	if (!extractWhitespace())
+		return false;
+
+	switch (input[pos])
+	{
+		case '\"': return extractString(node);
+		case '{' : return extractStruct(node);
+		case '[' : return extractArray(node);
+		default: break;
+	}
+
+	// scalars are parsed in the same way as for JsonNode, they need no allocations
+	JsonNode scalar;
+	const bool result = extractValue(scalar);
+
+	node.type = scalar.getType();
+	switch (scalar.getType())
+	{
+		case JsonNode::JsonType::DATA_BOOL:
+			node.data.Bool = scalar.Bool();
+			break;
+		case JsonNode::JsonType::DATA_FLOAT:
+			node.data.Float = scalar.Float();
+			break;
+		case JsonNode::JsonType::DATA_INTEGER:
+			node.data.Integer = scalar.Integer();
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+
+bool JsonParser::extractString(JsonTree::Node &node)
+{
+	node.type = JsonNode::JsonType::DATA_STRING;
+	node.data.first = static_cast<ui32>(tree->chars.size());
+
+	const bool result = extractString(tree->chars);
+	node.count = static_cast<ui32>(tree->chars.size() - node.data.first);
+	return result;
+}
+
+bool JsonParser::extractStruct(JsonTree::Node &node)
+{
+	pos++;
+
+	const size_t firstEntry = pending.size();
+	const bool result = extractStructEntries();
+	finishContainer(node, JsonNode::JsonType::DATA_STRUCT, firstEntry);
+	return result;
+}
+
+bool JsonParser::extractStructEntries()
+{
+	if (!extractWhitespace())
+		return false;
+
+	//Empty struct found
+	if (input[pos] == '}')
+	{
+		pos++;
+		return true;
+	}
+
+	while (true)
+	{
+		if (!extractWhitespace())
+			return false;
+
+		std::string key;
+		if (!extractString(key))
+			return false;
+
+		// flags are not stored in tree
+		std::vector<std::string> keyFlags;
+		extractKeyFlags(key, keyFlags);
+
+		if (!extractSeparator())
+			return false;
+
+		const ui32 keyIndex = internKey(std::move(key));
+		JsonTree::Node element = JsonTree::Node();
+		const bool parsed = extractElement(element, '}');
+		pending.push_back(std::make_pair(element, keyIndex));
+
+		if (!parsed)
+			return false;
+
+		if (input[pos] == '}')
+		{
+			pos++;
+			return true;
+		}
+	}
+}
+
+bool JsonParser::extractArray(JsonTree::Node &node)
+{
+	pos++;
+
+	const size_t firstEntry = pending.size();
+	const bool result = extractArrayEntries();
+	finishContainer(node, JsonNode::JsonType::DATA_VECTOR, firstEntry);
+	return result;
+}
+
+bool JsonParser::extractArrayEntries()
+{
+	if (!extractWhitespace())
+		return false;
+
+	//Empty array found
+	if (input[pos] == ']')
+	{
+		pos++;
+		return true;
+	}
+
+	while (true)
+	{
+		JsonTree::Node element = JsonTree::Node();
+		const bool parsed = extractElement(element, ']');
+		pending.push_back(std::make_pair(element, 0));
+
+		if (!parsed)
+			return false;
+
+		if (input[pos] == ']')
+		{
+			pos++;
+			return true;
+		}
+	}
+}
+
+bool JsonParser::extractElement(JsonTree::Node &node, char terminator)
+{
+	if (!extractValue(node))
+		return false;
+
+	return extractElementEnd(terminator);
+}
+
+void JsonParser::finishContainer(JsonTree::Node &node, JsonNode::JsonType type, size_t firstEntry)
+{
+	auto begin = pending.begin() + firstEntry;
+	if (type == JsonNode::JsonType::DATA_STRUCT)
+	{
+		// entries are ordered in the same way as in JsonMap
+		std::stable_sort(begin, pending.end(), [this](const std::pair<JsonTree::Node, ui32> &left, const std::pair<JsonTree::Node, ui32> &right)
+		{
+			return tree->keys[left.second] < tree->keys[right.second];
+		});
+	}
+
+	node.type = type;
+	node.data.first = static_cast<ui32>(tree->nodes.size());
+	for (auto entry = begin; entry != pending.end(); ++entry)
+	{
+		// of duplicated entries only the last one is kept
+		if (type == JsonNode::JsonType::DATA_STRUCT && entry + 1 != pending.end() && (entry + 1)->second == entry->second)
+		{
+			error("Dublicated element encountered!", true);
+			continue;
+		}
+		tree->nodes.push_back(entry->first);
+		tree->nodeKeys.push_back(entry->second);
+	}
+	node.count = static_cast<ui32>(tree->nodes.size() - node.data.first);
+	pending.erase(begin, pending.end());
+}
+
+ui32 JsonParser::internKey(std::string &&key)
+{
+	auto found = tree->keyIndexes.find(key);
+	if (found != tree->keyIndexes.end())
+		return found->second;
+
+	const ui32 index = static_cast<ui32>(tree->keys.size());
+	tree->keyIndexes[key] = index;
+	tree->keys.push_back(std::move(key));
+	return index;
+}
+
 bool JsonParser::error(const std::string &message, bool warning)
 {
 	std::ostringstream stream;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "JsonNode.h"
+#include "JsonView.h"
 
 class JsonWriter
 {
@@ -64,6 +65,8 @@ class JsonParser
 	ui32 lineCount; // Currently parsed line, starting from 1
 	size_t lineStart;       // Position of current line start
 	size_t pos;             // Current position of parser
+	JsonTree * tree;        // Tree that is being built, if any
+	std::vector<std::pair<JsonTree::Node, ui32>> pending; // Entries of containers that are being parsed, with index of their key
 
 	//Helpers
 	bool extractEscaping(std::string &str);
@@ -72,6 +75,8 @@ class JsonParser
 	bool extractWhitespace(bool verbose = true);
 	bool extractSeparator();
 	bool extractElement(JsonNode &node, char terminator);
+	bool extractElementEnd(char terminator);
+	void extractKeyFlags(std::string &key, std::vector<std::string> &flags);
 
 	//Methods for extracting JSON data
 	bool extractArray(JsonNode &node);
@@ -83,6 +88,21 @@ class JsonParser
 	bool extractTrue(JsonNode &node);
 	bool extractValue(JsonNode &node);
 
+	//Methods for building JsonTree directly. Nodes of entries are kept in pending
+	//until their container is closed and then moved to tree as one block
+	bool extractArray(JsonTree::Node &node);
+	bool extractArrayEntries();
+	bool extractElement(JsonTree::Node &node, char terminator);
+	bool extractString(JsonTree::Node &node);
+	bool extractStruct(JsonTree::Node &node);
+	bool extractStructEntries();
+	bool extractValue(JsonTree::Node &node);
+	void finishContainer(JsonTree::Node &node, JsonNode::JsonType type, size_t firstEntry);
+	ui32 internKey(std::string &&key);
+
+	template<typename Root>
+	void parseRoot(Root &root, const std::string &fileName);
+
 	//Add error\warning message to list
 	bool error(const std::string &message, bool warning=false);
 
@@ -91,6 +111,8 @@ public:
 
 	/// do actual parsing. filename is name of file that will printed to console if any errors were found
 	JsonNode parse(std::string fileName);
+	/// same as above, but builds immutable tree without intermediate JsonNode
+	void parse(std::string fileName, JsonTree &result);
 
 	/// returns true if parsing was successful
 	bool isValid();
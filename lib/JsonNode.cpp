@@ -87,6 +87,12 @@ JsonNode::JsonNode(const JsonNode &copy):
 	}
 }
 
+JsonNode::JsonNode(JsonNode &&other) noexcept:
+	type(JsonType::DATA_NULL)
+{
+	swap(other);
+}
+
 JsonNode::~JsonNode()
 {
 	setType(JsonType::DATA_NULL);
@@ -946,6 +952,9 @@ const JsonNode & getSchemaByName(std::string name)
 {
 	// cached schemas to avoid loading json data multiple times
 	static std::map<std::string, JsonNode> loadedSchemas;
+	// mods are validated on multiple threads
+	static boost::mutex loadedSchemasMutex;
+	boost::unique_lock<boost::mutex> lock(loadedSchemasMutex);
 
 	if (vstd::contains(loadedSchemas, name))
 		return loadedSchemas[name];
@@ -63,6 +63,8 @@ public:
 	explicit JsonNode(ResourceID && fileURI, bool & isValidSyntax);
 	//Copy c-tor
 	JsonNode(const JsonNode &copy);
+	//Move c-tor, source node becomes null
+	JsonNode(JsonNode &&other) noexcept;
 
 	~JsonNode();
 
@@ -0,0 +1,310 @@
+/*
+ * JsonView.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "JsonView.h"
+
+#include "JsonDetail.h"
+#include "filesystem/Filesystem.h"
+
+static const std::string emptyString;
+
+JsonTree::JsonTree(const JsonNode & root)
+	: rootIndex(0)
+{
+	// first pass - collect and intern all keys and metas
+	std::set<std::string> allKeys;
+	std::map<std::string, ui32> metaIndexes;
+	size_t nodesCount = 0;
+	size_t charsCount = 0;
+
+	std::function<void(const JsonNode &)> collect = [&](const JsonNode & node)
+	{
+		nodesCount++;
+		if(!vstd::contains(metaIndexes, node.meta))
+		{
+			metaIndexes[node.meta] = static_cast<ui32>(metas.size());
+			metas.push_back(node.meta);
+		}
+
+		switch(node.getType())
+		{
+		case JsonNode::JsonType::DATA_STRING:
+			charsCount += node.String().size();
+			break;
+		case JsonNode::JsonType::DATA_VECTOR:
+			for(auto & entry : node.Vector())
+				collect(entry);
+			break;
+		case JsonNode::JsonType::DATA_STRUCT:
+			for(auto & entry : node.Struct())
+			{
+				allKeys.insert(entry.first);
+				collect(entry.second);
+			}
+			break;
+		default:
+			break;
+		}
+	};
+	collect(root);
+
+	keys.assign(allKeys.begin(), allKeys.end());
+	for(size_t i = 0; i < keys.size(); i++)
+		keyIndexes[keys[i]] = static_cast<ui32>(i);
+
+	// second pass - breadth-first, so children of every node are placed in one block and root is first
+	nodes.resize(1);
+	nodes.reserve(nodesCount);
+	nodeKeys.assign(1, 0);
+	nodeKeys.reserve(nodesCount);
+	nodeMeta.assign(1, 0);
+	nodeMeta.reserve(nodesCount);
+	chars.reserve(charsCount);
+
+	std::queue<std::pair<const JsonNode *, ui32>> queue;
+	queue.push(std::make_pair(&root, 0));
+
+	auto addChild = [&](const JsonNode & child, ui32 key)
+	{
+		queue.push(std::make_pair(&child, static_cast<ui32>(nodes.size())));
+		nodes.push_back(Node());
+		nodeKeys.push_back(key);
+		nodeMeta.push_back(0);
+	};
+
+	while(!queue.empty())
+	{
+		const JsonNode & source = *queue.front().first;
+		const ui32 index = queue.front().second;
+		queue.pop();
+
+		Node & target = nodes[index];
+		target.type = source.getType();
+		target.count = 0;
+		target.data.Integer = 0;
+		nodeMeta[index] = metaIndexes.at(source.meta);
+
+		switch(source.getType())
+		{
+		case JsonNode::JsonType::DATA_BOOL:
+			target.data.Bool = source.Bool();
+			break;
+		case JsonNode::JsonType::DATA_FLOAT:
+			target.data.Float = source.Float();
+			break;
+		case JsonNode::JsonType::DATA_INTEGER:
+			target.data.Integer = source.Integer();
+			break;
+		case JsonNode::JsonType::DATA_STRING:
+			target.data.first = static_cast<ui32>(chars.size());
+			target.count = static_cast<ui32>(source.String().size());
+			chars += source.String();
+			break;
+		case JsonNode::JsonType::DATA_VECTOR:
+			target.data.first = static_cast<ui32>(nodes.size());
+			target.count = static_cast<ui32>(source.Vector().size());
+			for(auto & entry : source.Vector())
+				addChild(entry, 0);
+			break;
+		case JsonNode::JsonType::DATA_STRUCT:
+			target.data.first = static_cast<ui32>(nodes.size());
+			target.count = static_cast<ui32>(source.Struct().size());
+			//JsonMap is sorted by key, so entries are sorted by key index as well
+			for(auto & entry : source.Struct())
+				addChild(entry.second, keyIndexes.at(entry.first));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+JsonTree::JsonTree(const char * data, size_t datasize)
+	: rootIndex(0)
+{
+	JsonParser parser(data, datasize);
+	parser.parse("<unknown>", *this);
+}
+
+JsonTree::JsonTree(const ResourceID & fileURI)
+	: rootIndex(0)
+{
+	auto file = CResourceHandler::get()->load(fileURI)->readAll();
+
+	JsonParser parser(reinterpret_cast<char*>(file.first.get()), file.second);
+	parser.parse(fileURI.getName(), *this);
+}
+
+JsonView JsonTree::root() const
+{
+	return JsonView(this, rootIndex);
+}
+
+size_t JsonTree::memoryUsage() const
+{
+	size_t result = nodes.capacity() * sizeof(Node);
+	result += (nodeKeys.capacity() + nodeMeta.capacity()) * sizeof(ui32);
+	result += chars.capacity();
+	for(auto & key : keys)
+		result += sizeof(std::string) * 2 + key.capacity() + sizeof(ui32);
+	for(auto & meta : metas)
+		result += sizeof(std::string) + meta.capacity();
+	return result;
+}
+
+JsonView::JsonView()
+	: tree(nullptr), index(0)
+{
+}
+
+JsonView::JsonView(const JsonTree * tree, ui32 index)
+	: tree(tree), index(index)
+{
+}
+
+const JsonTree::Node & JsonView::node() const
+{
+	return tree->nodes[index];
+}
+
+JsonNode::JsonType JsonView::getType() const
+{
+	if(!tree)
+		return JsonNode::JsonType::DATA_NULL;
+	return node().type;
+}
+
+bool JsonView::isNull() const
+{
+	return getType() == JsonNode::JsonType::DATA_NULL;
+}
+
+bool JsonView::isNumber() const
+{
+	return getType() == JsonNode::JsonType::DATA_INTEGER || getType() == JsonNode::JsonType::DATA_FLOAT;
+}
+
+bool JsonView::Bool() const
+{
+	if(isNull())
+		return false;
+	assert(getType() == JsonNode::JsonType::DATA_BOOL);
+	return node().data.Bool;
+}
+
+double JsonView::Float() const
+{
+	if(isNull())
+		return 0;
+	else if(getType() == JsonNode::JsonType::DATA_INTEGER)
+		return static_cast<double>(node().data.Integer);
+
+	assert(getType() == JsonNode::JsonType::DATA_FLOAT);
+	return node().data.Float;
+}
+
+si64 JsonView::Integer() const
+{
+	if(isNull())
+		return 0;
+	else if(getType() == JsonNode::JsonType::DATA_FLOAT)
+		return static_cast<si64>(node().data.Float);
+
+	assert(getType() == JsonNode::JsonType::DATA_INTEGER);
+	return node().data.Integer;
+}
+
+boost::string_ref JsonView::String() const
+{
+	if(isNull())
+		return boost::string_ref();
+	assert(getType() == JsonNode::JsonType::DATA_STRING);
+	return boost::string_ref(tree->chars.data() + node().data.first, node().count);
+}
+
+const std::string & JsonView::meta() const
+{
+	if(!tree)
+		return emptyString;
+	return tree->metas[tree->nodeMeta[index]];
+}
+
+size_t JsonView::size() const
+{
+	if(getType() != JsonNode::JsonType::DATA_VECTOR && getType() != JsonNode::JsonType::DATA_STRUCT)
+		return 0;
+	return node().count;
+}
+
+JsonView JsonView::operator[](size_t position) const
+{
+	if(position >= size())
+		return JsonView();
+	return JsonView(tree, node().data.first + static_cast<ui32>(position));
+}
+
+const std::string & JsonView::keyAt(size_t position) const
+{
+	if(getType() != JsonNode::JsonType::DATA_STRUCT || position >= size())
+		return emptyString;
+	return tree->keys[tree->nodeKeys[node().data.first + position]];
+}
+
+JsonView JsonView::operator[](const std::string & child) const
+{
+	if(getType() != JsonNode::JsonType::DATA_STRUCT)
+		return JsonView();
+
+	auto key = tree->keyIndexes.find(child);
+	if(key == tree->keyIndexes.end())
+		return JsonView();
+
+	auto begin = tree->nodeKeys.begin() + node().data.first;
+	auto end = begin + node().count;
+	auto entry = std::lower_bound(begin, end, key->second);
+
+	if(entry == end || *entry != key->second)
+		return JsonView();
+	return JsonView(tree, static_cast<ui32>(entry - tree->nodeKeys.begin()));
+}
+
+JsonNode JsonView::toJsonNode() const
+{
+	JsonNode result(getType());
+	result.meta = meta();
+
+	switch(getType())
+	{
+	case JsonNode::JsonType::DATA_BOOL:
+		result.Bool() = Bool();
+		break;
+	case JsonNode::JsonType::DATA_FLOAT:
+		result.Float() = Float();
+		break;
+	case JsonNode::JsonType::DATA_INTEGER:
+		result.Integer() = Integer();
+		break;
+	case JsonNode::JsonType::DATA_STRING:
+		result.String() = String().to_string();
+		break;
+	case JsonNode::JsonType::DATA_VECTOR:
+		result.Vector().reserve(size());
+		for(size_t i = 0; i < size(); i++)
+			result.Vector().push_back((*this)[i].toJsonNode());
+		break;
+	case JsonNode::JsonType::DATA_STRUCT:
+		for(size_t i = 0; i < size(); i++)
+			result.Struct()[keyAt(i)] = (*this)[i].toJsonNode();
+		break;
+	default:
+		break;
+	}
+	return result;
+}
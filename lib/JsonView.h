@@ -0,0 +1,103 @@
+/*
+ * JsonView.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "JsonNode.h"
+
+#include <boost/utility/string_ref.hpp>
+
+class JsonView;
+class JsonParser;
+class ResourceID;
+
+/// Immutable compact copy of json tree, for data that is only read after loading.
+/// All nodes are stored in one array with children of each node placed next to each other,
+/// all strings are stored in one buffer and struct keys are interned.
+/// Entries of every struct are sorted by key, same as in JsonMap
+class DLL_LINKAGE JsonTree : public boost::noncopyable
+{
+	friend class JsonView;
+	friend class JsonParser;
+
+	struct Node
+	{
+		JsonNode::JsonType type;
+		ui32 count; //number of children for vector and struct, length for string
+		union
+		{
+			bool Bool;
+			double Float;
+			si64 Integer;
+			ui32 first; //index of first child for vector and struct, offset in chars for string
+		} data;
+	};
+
+	std::vector<Node> nodes;
+	ui32 rootIndex;
+	std::vector<ui32> nodeKeys; //key of node in parent struct, index in keys
+	std::vector<ui32> nodeMeta; //index in metas
+
+	std::vector<std::string> keys; //sorted, so order of key indexes is the same as order of keys
+	std::unordered_map<std::string, ui32> keyIndexes;
+	std::vector<std::string> metas;
+	std::string chars;
+
+public:
+	explicit JsonTree(const JsonNode & root);
+	/// parses json text directly into tree, see JsonNode constructors with same arguments
+	JsonTree(const char * data, size_t datasize);
+	explicit JsonTree(const ResourceID & fileURI);
+
+	JsonView root() const;
+
+	/// approximate amount of memory used by tree
+	size_t memoryUsage() const;
+};
+
+/// Read-only handle to node of JsonTree. Cheap to copy, valid as long as tree exists.
+/// Accessors follow const accessors of JsonNode: null node returns default value, missing struct entries are null
+class DLL_LINKAGE JsonView
+{
+	friend class JsonTree;
+
+	const JsonTree * tree;
+	ui32 index;
+
+	JsonView(const JsonTree * tree, ui32 index);
+	const JsonTree::Node & node() const;
+public:
+	/// creates null node
+	JsonView();
+
+	JsonNode::JsonType getType() const;
+	bool isNull() const;
+	bool isNumber() const;
+
+	bool Bool() const;
+	///float and integer allowed
+	double Float() const;
+	///float and integer allowed
+	si64 Integer() const;
+	boost::string_ref String() const;
+	const std::string & meta() const;
+
+	/// number of entries in vector or struct
+	size_t size() const;
+	/// entry of vector or struct by position
+	JsonView operator[](size_t position) const;
+	/// key of struct entry by position
+	const std::string & keyAt(size_t position) const;
+
+	//operator [], for structs only - get child node by name
+	JsonView operator[](const std::string & child) const;
+
+	/// creates regular json tree from this node, flags are not preserved
+	JsonNode toJsonNode() const;
+};
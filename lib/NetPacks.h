@@ -18,9 +18,11 @@
 #include "ResourceSet.h"
 #include "CGameStateFwd.h"
 #include "mapping/CMapDefines.h"
+#include "mapping/CTileSet.h"
 #include "battle/CObstacleInstance.h"
 
 #include "spells/ViewSpellInt.h"
+#include "serializer/CPackJournal.h"
 
 class CClient;
 class CGameState;
@@ -108,6 +110,7 @@ struct PlayerBlocked : public CPackForClient
 {
 	PlayerBlocked() : reason(UPCOMING_BATTLE), startOrEnd(BLOCKADE_STARTED) {}
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	enum EReason { UPCOMING_BATTLE, ONGOING_MOVEMENT };
 	enum EMode { BLOCKADE_STARTED, BLOCKADE_ENDED };
@@ -301,14 +304,24 @@ struct FoWChange : public CPackForClient
 	FoWChange(){mode = 0; waitForDialogs = false;}
 	void applyCl(CClient *cl);
 	DLL_LINKAGE void applyGs(CGameState *gs);
+	DLL_LINKAGE void loadOldTiles(const std::unordered_set<int3, ShashInt3> & oldTiles);
 
-	std::unordered_set<int3, struct ShashInt3 > tiles;
+	CTileSet tiles;
 	PlayerColor player;
 	ui8 mode; //mode==0 - hide, mode==1 - reveal
 	bool waitForDialogs;
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
-		h & tiles;
+		if(version >= 797)
+		{
+			h & tiles;
+		}
+		else
+		{
+			std::unordered_set<int3, ShashInt3> oldTiles; //loading only, packs from journals of older saves
+			h & oldTiles;
+			loadOldTiles(oldTiles);
+		}
 		h & player;
 		h & mode;
 		h & waitForDialogs;
@@ -1037,6 +1050,7 @@ struct NewTurn : public CPackForClient
 struct InfoWindow : public CPackForClient //103  - displays simple info window
 {
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	MetaString text;
 	std::vector<Component> components;
@@ -1194,6 +1208,7 @@ struct BlockingDialog : public Query
 	enum {ALLOW_CANCEL = 1, SELECTION = 2};
 
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	MetaString text;
 	std::vector<Component> components;
@@ -1238,6 +1253,7 @@ struct GarrisonDialog : public Query
 {
 	GarrisonDialog():removableUnits(false){}
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 	ObjectInstanceID objid, hid;
 	bool removableUnits;
 
@@ -1254,6 +1270,7 @@ struct ExchangeDialog : public Query
 {
 	ExchangeDialog() {}
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	PlayerColor player;
 
@@ -1280,6 +1297,7 @@ struct TeleportDialog : public Query
 	{}
 
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	PlayerColor player;
 	TeleportChannelID channel;
@@ -1307,6 +1325,7 @@ struct MapObjectSelectDialog : public Query
 	MapObjectSelectDialog(){};
 
 	void applyCl(CClient * cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	template <typename Handler> void serialize(Handler & h, const int version)
 	{
@@ -1806,6 +1825,7 @@ struct ShowInInfobox : public CPackForClient
 	MetaString text;
 
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
 		h & player;
@@ -1821,6 +1841,7 @@ struct AdvmapSpellCast : public CPackForClient
 	SpellID spellID;
 
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
 		h & casterID;
@@ -1837,6 +1858,7 @@ struct ShowWorldViewEx : public CPackForClient
 	ShowWorldViewEx(){}
 
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
@@ -2250,9 +2272,10 @@ struct CastAdvSpell : public CPackForServer
 
 struct SaveGame : public CPackForServer
 {
-	SaveGame(){};
-	SaveGame(const std::string &Fname) :fname(Fname){};
+	SaveGame():allowDelta(false){};
+	SaveGame(const std::string &Fname, bool AllowDelta = false) :fname(Fname), allowDelta(AllowDelta){};
 	std::string fname;
+	bool allowDelta; //server may store only packs applied since last full save
 
 	void applyGs(CGameState *gs){};
 	bool applyGh(CGameHandler *gh);
@@ -2260,20 +2283,25 @@ struct SaveGame : public CPackForServer
 	{
 		h & static_cast<CPackForServer &>(*this);
 		h & fname;
+		h & allowDelta;
 	}
 };
 
 // TODO: Eventually we should re-merge both SaveGame and PlayerMessage
 struct SaveGameClient : public CPackForClient
 {
-	SaveGameClient(){};
-	SaveGameClient(const std::string &Fname) :fname(Fname){};
+	SaveGameClient():delta(false){};
+	SaveGameClient(const std::string &Fname) :fname(Fname), delta(false){};
 	std::string fname;
+	SaveCheckpoint checkpoint; //checkpoint this save belongs to
+	bool delta; //if true, game state is not stored and will be restored from server part of save
 
 	void applyCl(CClient *cl);
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
 		h & fname;
+		h & checkpoint;
+		h & delta;
 	}
 };
 
@@ -2315,10 +2343,29 @@ struct PlayerMessageClient : public CPackForClient
 	}
 };
 
+/// Digest of server game state, client compares it with own one to detect desynchronization
+struct GameStateDigest : public CPackForClient
+{
+	GameStateDigest():packsCount(0), digest(0), summary(0){};
+	void applyFirstCl(CClient *cl);
+
+	ui32 packsCount; //number of applied packs that changed game state
+	ui32 digest; //see CStateDigest::value
+	ui32 summary; //see CStateDigest::summary
+
+	template <typename Handler> void serialize(Handler &h, const int version)
+	{
+		h & packsCount;
+		h & digest;
+		h & summary;
+	}
+};
+
 struct CenterView : public CPackForClient
 {
 	CenterView():focusTime(0){};
 	void applyCl(CClient *cl);
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const;
 
 	PlayerColor player;
 	int3 pos;
@@ -51,6 +51,10 @@ struct CPackForClient : public CPack
 	{}
 	void applyCl(CClient *cl)//called after applying to gs
 	{}
+	bool visibleTo(CGameHandler *gh, PlayerColor player) const //called by server to skip sending pack to clients that don't need it
+	{
+		return true;
+	}
 };
 
 struct CPackForServer : public CPack
@@ -177,11 +177,26 @@ DLL_LINKAGE void SetMovePoints::applyGs(CGameState *gs)
 DLL_LINKAGE void FoWChange::applyGs(CGameState *gs)
 {
 	TeamState * team = gs->getPlayerTeam(player);
-	for(int3 t : tiles)
-		team->fogOfWarMap[t.x][t.y][t.z] = mode;
+	if(tiles.getMapSize() == team->fogOfWarMap.getMapSize())
+	{
+		if(mode)
+			team->fogOfWarMap |= tiles;
+		else
+			team->fogOfWarMap -= tiles;
+	}
+	else //old packs, see loadOldTiles
+	{
+		for(int3 t : tiles)
+		{
+			if(mode)
+				team->fogOfWarMap.insert(t);
+			else
+				team->fogOfWarMap.erase(t);
+		}
+	}
 	if (mode == 0) //do not hide too much
 	{
-		std::unordered_set<int3, ShashInt3> tilesRevealed;
+		CTileSet tilesRevealed;
 		for (auto & elem : gs->map->objects)
 		{
 			const CGObjectInstance *o = elem;
@@ -199,11 +214,25 @@ DLL_LINKAGE void FoWChange::applyGs(CGameState *gs)
 				}
 			}
 		}
-		for(int3 t : tilesRevealed) //probably not the most optimal solution ever
-			team->fogOfWarMap[t.x][t.y][t.z] = 1;
+		team->fogOfWarMap |= tilesRevealed;
 	}
 }
 
+DLL_LINKAGE void FoWChange::loadOldTiles(const std::unordered_set<int3, ShashInt3> & oldTiles)
+{
+	//size of map is not known here, set is just big enough to hold all tiles
+	int3 size(0, 0, 0);
+	for(const int3 & t : oldTiles)
+	{
+		size.x = std::max(size.x, t.x + 1);
+		size.y = std::max(size.y, t.y + 1);
+		size.z = std::max(size.z, t.z + 1);
+	}
+	tiles = CTileSet(size);
+	for(const int3 & t : oldTiles)
+		tiles.insert(t);
+}
+
 DLL_LINKAGE void SetAvailableHeroes::applyGs(CGameState *gs)
 {
 	PlayerState *p = gs->getPlayer(player);
@@ -425,6 +454,7 @@ DLL_LINKAGE void RemoveObject::applyGs(CGameState *gs)
 		if(h->boat)
 		{
 			gs->map->instanceNames.erase(h->boat->instanceName);
+			gs->map->objectIndex.remove(h->boat);
 			gs->map->objects[h->boat->id.getNum()].dellNull();
 			h->boat = nullptr;
 		}
@@ -561,7 +591,7 @@ void TryMoveHero::applyGs(CGameState *gs)
 	}
 
 	for(int3 t : fowRevealed)
-		gs->getPlayerTeam(h->getOwner())->fogOfWarMap[t.x][t.y][t.z] = 1;
+		gs->getPlayerTeam(h->getOwner())->fogOfWarMap.insert(t);
 }
 
 DLL_LINKAGE void NewStructures::applyGs(CGameState *gs)
@@ -1258,6 +1288,9 @@ DLL_LINKAGE void SetObjectProperty::applyGs(CGameState *gs)
 	{
 		obj->setProperty(what,val);
 	}
+
+	if(what == ObjProperty::OWNER || what == ObjProperty::ID)
+		gs->map->objectIndex.update(obj);
 }
 
 DLL_LINKAGE void PrepareHeroLevelUp::applyGs(CGameState * gs)
@@ -79,53 +79,56 @@ void LibClasses::loadFilesystem(bool onlyEssential)
 	logGlobal->info("Basic initialization: %d ms", totalTime.getDiff());
 }
 
-static void logHandlerLoaded(const std::string & name, CStopWatch & timer)
+static void logHandlerLoaded(const std::string & name, CStopWatch & timer, CMemoryWatch & memory)
 {
-   logGlobal->info("\t\t %s handler: %d ms", name, timer.getDiff());
+   logGlobal->info("\t\t %s handler: %d ms, %d KB", name, timer.getDiff(), memory.getDiff());
 }
 
-template <class Handler> void createHandler(Handler *&handler, const std::string &name, CStopWatch &timer)
+template <class Handler> void createHandler(Handler *&handler, const std::string &name, CStopWatch &timer, CMemoryWatch &memory)
 {
 	handler = new Handler();
-	logHandlerLoaded(name, timer);
+	logHandlerLoaded(name, timer, memory);
 }
 
 void LibClasses::init(bool onlyEssential)
 {
 	CStopWatch pomtime, totalTime;
+	CMemoryWatch memory, totalMemory;
 
 	modh->initializeConfig();
 
-	createHandler(bth, "Bonus type", pomtime);
+	createHandler(bth, "Bonus type", pomtime, memory);
 
-	createHandler(generaltexth, "General text", pomtime);
+	createHandler(generaltexth, "General text", pomtime, memory);
 
-	createHandler(heroh, "Hero", pomtime);
+	createHandler(heroh, "Hero", pomtime, memory);
 
-	createHandler(arth, "Artifact", pomtime);
+	createHandler(arth, "Artifact", pomtime, memory);
 
-	createHandler(creh, "Creature", pomtime);
+	createHandler(creh, "Creature", pomtime, memory);
 
-	createHandler(townh, "Town", pomtime);
+	createHandler(townh, "Town", pomtime, memory);
 
-	createHandler(objh, "Object", pomtime);
+	createHandler(objh, "Object", pomtime, memory);
 
-	createHandler(objtypeh, "Object types information", pomtime);
+	createHandler(objtypeh, "Object types information", pomtime, memory);
 
-	createHandler(spellh, "Spell", pomtime);
+	createHandler(spellh, "Spell", pomtime, memory);
 
-	createHandler(skillh, "Skill", pomtime);
+	createHandler(skillh, "Skill", pomtime, memory);
 
-	createHandler(terviewh, "Terrain view pattern", pomtime);
+	createHandler(terviewh, "Terrain view pattern", pomtime, memory);
 
-	createHandler(tplh, "Template", pomtime); //templates need already resolved identifiers (refactor?)
+	createHandler(tplh, "Template", pomtime, memory); //templates need already resolved identifiers (refactor?)
 
-	logGlobal->info("\tInitializing handlers: %d ms", totalTime.getDiff());
+	logGlobal->info("\tInitializing handlers: %d ms, %d KB", totalTime.getDiff(), totalMemory.getDiff());
 
 	modh->load();
 
 	modh->afterLoad(onlyEssential);
 
+	logGlobal->info("\tLoading game content: %d ms, %d KB", totalTime.getDiff(), totalMemory.getDiff());
+
 	//FIXME: make sure that everything is ok after game restart
 	//TODO: This should be done every time mod config changes
 }
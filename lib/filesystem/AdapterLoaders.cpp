@@ -54,7 +54,8 @@ std::unordered_set<ResourceID> CMappedFileLoader::getFilteredFiles(std::function
 	return foundID;
 }
 
-CFilesystemList::CFilesystemList()
+CFilesystemList::CFilesystemList():
+	parent(nullptr)
 {
 	//loaders = new std::vector<std::unique_ptr<ISimpleResourceLoader> >;
 }
@@ -66,12 +67,12 @@ CFilesystemList::~CFilesystemList()
 
 std::unique_ptr<CInputStream> CFilesystemList::load(const ResourceID & resourceName) const
 {
+	auto currentIndex = getIndex();
+	auto entry = currentIndex->find(resourceName);
+
 	// load resource from last loader that have it (last overridden version)
-	for (auto & loader : boost::adaptors::reverse(loaders))
-	{
-		if (loader->existsResource(resourceName))
-			return loader->load(resourceName);
-	}
+	if (entry != currentIndex->end())
+		return entry->second.back()->load(resourceName);
 
 	throw std::runtime_error("Resource with name " + resourceName.getName() + " and type "
 		+ EResTypeHelper::getEResTypeAsString(resourceName.getType()) + " wasn't found.");
@@ -79,10 +80,7 @@ std::unique_ptr<CInputStream> CFilesystemList::load(const ResourceID & resourceN
 
 bool CFilesystemList::existsResource(const ResourceID & resourceName) const
 {
-	for (auto & loader : loaders)
-		if (loader->existsResource(resourceName))
-			return true;
-	return false;
+	return getIndex()->count(resourceName) != 0;
 }
 
 std::string CFilesystemList::getMountPoint() const
@@ -115,6 +113,7 @@ void CFilesystemList::updateFilteredFiles(std::function<bool(const std::string &
 {
 	for (auto & loader : loaders)
 		loader->updateFilteredFiles(filter);
+	invalidateIndex();
 }
 
 std::unordered_set<ResourceID> CFilesystemList::getFilteredFiles(std::function<bool(const ResourceID &)> filter) const
@@ -136,6 +135,8 @@ bool CFilesystemList::createResource(std::string filename, bool update)
 		if (writeableLoaders.count(loader.get()) != 0                       // writeable,
 			&& loader->createResource(filename, update))          // successfully created
 		{
+			invalidateIndex();
+
 			// Check if resource was created successfully. Possible reasons for this to fail
 			// a) loader failed to create resource (e.g. read-only FS)
 			// b) in update mode, call with filename that does not exists
@@ -151,17 +152,83 @@ bool CFilesystemList::createResource(std::string filename, bool update)
 
 std::vector<const ISimpleResourceLoader *> CFilesystemList::getResourcesWithName(const ResourceID & resourceName) const
 {
-	std::vector<const ISimpleResourceLoader *> ret;
-
-	for (auto & loader : loaders)
-		boost::range::copy(loader->getResourcesWithName(resourceName), std::back_inserter(ret));
+	auto currentIndex = getIndex();
+	auto entry = currentIndex->find(resourceName);
 
-	return ret;
+	if (entry != currentIndex->end())
+		return entry->second;
+	return std::vector<const ISimpleResourceLoader *>();
 }
 
 void CFilesystemList::addLoader(ISimpleResourceLoader * loader, bool writeable)
 {
+	auto list = dynamic_cast<CFilesystemList *>(loader);
+	if (list)
+	{
+		assert(!list->parent);
+		list->parent = this;
+	}
+
 	loaders.push_back(std::unique_ptr<ISimpleResourceLoader>(loader));
 	if (writeable)
 		writeableLoaders.insert(loader);
+	invalidateIndex();
+}
+
+void CFilesystemList::invalidateIndex() const
+{
+	{
+		// rebuild in progress holds the lock, so it can't publish index that misses this change
+		boost::unique_lock<boost::mutex> lock(indexMutex);
+		std::atomic_store(&index, std::shared_ptr<const TResourceIndex>());
+	}
+	if (parent)
+		parent->invalidateIndex();
+}
+
+std::shared_ptr<const CFilesystemList::TResourceIndex> CFilesystemList::getIndex() const
+{
+	auto current = std::atomic_load(&index);
+	if (current)
+		return current;
+
+	boost::unique_lock<boost::mutex> lock(indexMutex);
+	current = std::atomic_load(&index);
+	if (current)
+		return current; // built by another thread while this one was waiting
+
+	auto newIndex = std::make_shared<TResourceIndex>();
+	for (auto & loader : loaders)
+	{
+		// nested lists are merged from their own indexes, so each list is scanned only once
+		auto list = dynamic_cast<const CFilesystemList *>(loader.get());
+		if (list)
+		{
+			for (auto & entry : *list->getIndex())
+				vstd::concatenate((*newIndex)[entry.first], entry.second);
+		}
+		else
+		{
+			for (auto & entry : loader->getFilteredFiles([](const ResourceID &){ return true; }))
+				(*newIndex)[entry].push_back(loader.get());
+		}
+	}
+
+	std::atomic_store(&index, std::shared_ptr<const TResourceIndex>(newIndex));
+	return newIndex;
+}
+
+size_t CFilesystemList::getIndexMemoryUsage() const
+{
+	auto currentIndex = getIndex();
+
+	size_t result = currentIndex->bucket_count() * sizeof(void *);
+	for (auto & entry : *currentIndex)
+	{
+		// node of hash table, name of resource and list of loaders
+		result += sizeof(TResourceIndex::value_type) + sizeof(void *);
+		result += entry.first.getName().size() + 1;
+		result += entry.second.capacity() * sizeof(const ISimpleResourceLoader *);
+	}
+	return result;
 }
@@ -53,10 +53,26 @@ private:
 
 class DLL_LINKAGE CFilesystemList : public ISimpleResourceLoader
 {
+	/// For every resource - all non-list loaders that contain it, in order in which they were added
+	typedef std::unordered_map<ResourceID, std::vector<const ISimpleResourceLoader *> > TResourceIndex;
+
 	std::vector<std::unique_ptr<ISimpleResourceLoader> > loaders;
 
 	std::set<ISimpleResourceLoader *> writeableLoaders;
 
+	/// list this one was added to, its index contains files of this list
+	CFilesystemList * parent;
+
+	/// serializes rebuilds, lookups only load index atomically
+	mutable boost::mutex indexMutex;
+	/// immutable once published, null if it has to be rebuilt. Accessed only through std::atomic_load and std::atomic_store
+	mutable std::shared_ptr<const TResourceIndex> index;
+
+	/// Returns index of all loaders of this list, rebuilds it if it was invalidated
+	std::shared_ptr<const TResourceIndex> getIndex() const;
+	/// Drops index of this list and of all its parents, must be called whenever set of files changes
+	void invalidateIndex() const;
+
 	//FIXME: this is only compile fix, should be removed in the end
 	CFilesystemList(CFilesystemList &) = delete;
 	CFilesystemList &operator=(CFilesystemList &) = delete;
@@ -84,4 +100,7 @@ public:
 	 * @param writeable - resource shall be treated as writeable
 	 */
 	void addLoader(ISimpleResourceLoader * loader, bool writeable);
+
+	/// approximate amount of memory used by resource index of this list
+	size_t getIndexMemoryUsage() const;
 };
@@ -12,9 +12,12 @@
 
 #include "CFileInputStream.h"
 #include "CCompressedStream.h"
+#include "CMemoryStream.h"
 
 #include "CBinaryReader.h"
 
+#include <boost/interprocess/mapped_region.hpp>
+
 ArchiveEntry::ArchiveEntry()
 	: offset(0), fullSize(0), compressedSize(0)
 {
@@ -25,8 +28,16 @@ CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path
     archive(std::move(_archive)),
     mountPoint(std::move(_mountPoint))
 {
+	mapArchive();
+
 	// Open archive file(.snd, .vid, .lod)
-	CFileInputStream fileStream(archive);
+	std::unique_ptr<CInputStream> archiveStream;
+	if(mapping)
+		archiveStream = make_unique<CMappedFileStream>(mapping, 0, mapping->get_size());
+	else
+		archiveStream = make_unique<CFileInputStream>(archive);
+
+	CInputStream & fileStream = *archiveStream;
 
 	// Fake .lod file with no data has to be silently ignored.
 	if(fileStream.getSize() < 10)
@@ -48,7 +59,7 @@ CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path
 	logGlobal->trace("%sArchive \"%s\" loaded (%d files found).", ext, archive.filename(), entries.size());
 }
 
-void CArchiveLoader::initLODArchive(const std::string &mountPoint, CFileInputStream & fileStream)
+void CArchiveLoader::initLODArchive(const std::string &mountPoint, CInputStream & fileStream)
 {
 	// Read count of total files
 	CBinaryReader reader(&fileStream);
@@ -78,7 +89,7 @@ void CArchiveLoader::initLODArchive(const std::string &mountPoint, CFileInputStr
 	}
 }
 
-void CArchiveLoader::initVIDArchive(const std::string &mountPoint, CFileInputStream & fileStream)
+void CArchiveLoader::initVIDArchive(const std::string &mountPoint, CInputStream & fileStream)
 {
 
 	// Read count of total files
@@ -113,7 +124,7 @@ void CArchiveLoader::initVIDArchive(const std::string &mountPoint, CFileInputStr
 	}
 }
 
-void CArchiveLoader::initSNDArchive(const std::string &mountPoint, CFileInputStream & fileStream)
+void CArchiveLoader::initSNDArchive(const std::string &mountPoint, CInputStream & fileStream)
 {
 	// Read count of total files
 	CBinaryReader reader(&fileStream);
@@ -146,6 +157,21 @@ std::unique_ptr<CInputStream> CArchiveLoader::load(const ResourceID & resourceNa
 
 	const ArchiveEntry & entry = entries.at(resourceName);
 
+	if (mapping)
+	{
+		// entries are read directly from mapped archive, compressed ones are inflated from it without intermediate copy
+		const si64 storedSize = entry.compressedSize != 0 ? entry.compressedSize : entry.fullSize;
+		if (entry.offset >= 0 && storedSize >= 0 && entry.offset + storedSize <= static_cast<si64>(mapping->get_size()))
+		{
+			std::unique_ptr<CInputStream> entryStream = make_unique<CMappedFileStream>(mapping, entry.offset, storedSize);
+
+			if (entry.compressedSize != 0)
+				return make_unique<CCompressedStream>(std::move(entryStream), false, entry.fullSize);
+			return entryStream;
+		}
+		logGlobal->warn("Entry %s is outside of archive %s", entry.name, archive.string());
+	}
+
 	if (entry.compressedSize != 0) //compressed data
 	{
 		auto fileStream = make_unique<CFileInputStream>(archive, entry.offset, entry.compressedSize);
@@ -168,6 +194,16 @@ std::string CArchiveLoader::getMountPoint() const
 	return mountPoint;
 }
 
+void CArchiveLoader::mapArchive()
+{
+	// fake archives without data are ignored by constructor, empty files can't be mapped anyway
+	boost::system::error_code error;
+	if(boost::filesystem::file_size(archive, error) < 10 || error)
+		return;
+
+	mapping = CMappedFileStream::mapFile(archive);
+}
+
 std::unordered_set<ResourceID> CArchiveLoader::getFilteredFiles(std::function<bool(const ResourceID &)> filter) const
 {
 	std::unordered_set<ResourceID> foundID;
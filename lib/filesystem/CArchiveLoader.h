@@ -11,8 +11,7 @@
 
 #include "ISimpleResourceLoader.h"
 #include "ResourceID.h"
-
-class CFileInputStream;
+#include "CMemoryStream.h"
 
 /**
  * A struct which holds information about the archive entry e.g. where it is located in space of the archive container.
@@ -67,27 +66,35 @@ private:
 	/**
 	 * Initializes a LOD archive.
 	 *
-	 * @param fileStream File stream to the .lod archive
+	 * @param fileStream Stream to the .lod archive
 	 */
-	void initLODArchive(const std::string &mountPoint, CFileInputStream & fileStream);
+	void initLODArchive(const std::string &mountPoint, CInputStream & fileStream);
 
 	/**
 	 * Initializes a VID archive.
 	 *
-	 * @param fileStream File stream to the .vid archive
+	 * @param fileStream Stream to the .vid archive
 	 */
-	void initVIDArchive(const std::string &mountPoint, CFileInputStream & fileStream);
+	void initVIDArchive(const std::string &mountPoint, CInputStream & fileStream);
 
 	/**
 	 * Initializes a SND archive.
 	 *
-	 * @param fileStream File stream to the .snd archive
+	 * @param fileStream Stream to the .snd archive
 	 */
-	void initSNDArchive(const std::string &mountPoint, CFileInputStream & fileStream);
+	void initSNDArchive(const std::string &mountPoint, CInputStream & fileStream);
+
+	/**
+	 * Maps whole archive into memory. On failure archive will be read through file streams.
+	 */
+	void mapArchive();
 
 	/** The file path to the archive which is scanned and indexed. */
 	boost::filesystem::path archive;
 
+	/** Read-only mapping of whole archive or nullptr if archive is not mapped. Shared with all loaded streams. */
+	CMappedFileStream::TMapping mapping;
+
 	std::string mountPoint;
 
 	/** Holds all entries of the archive file. An entry can be accessed via the entry name. **/
@@ -12,6 +12,7 @@
 
 #include <SDL_endian.h>
 #include "CInputStream.h"
+#include "CMemoryStream.h"
 #include "../CGeneralTextHandler.h"
 
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
@@ -30,12 +31,13 @@ CData readLE(CData data)
 }
 #endif
 
-CBinaryReader::CBinaryReader() : stream(nullptr)
+CBinaryReader::CBinaryReader() : stream(nullptr), memoryStream(nullptr)
 {
 }
 
 CBinaryReader::CBinaryReader(CInputStream * stream) : stream(stream)
 {
+	memoryStream = dynamic_cast<CMemoryStream *>(stream);
 }
 
 CInputStream * CBinaryReader::getStream()
@@ -46,6 +48,7 @@ CInputStream * CBinaryReader::getStream()
 void CBinaryReader::setStream(CInputStream * stream)
 {
 	this->stream = stream;
+	memoryStream = dynamic_cast<CMemoryStream *>(stream);
 }
 
 si64 CBinaryReader::read(ui8 * data, si64 size)
@@ -58,6 +61,24 @@ si64 CBinaryReader::read(ui8 * data, si64 size)
 	return bytesRead;
 }
 
+const ui8 * CBinaryReader::readBlock(si64 size)
+{
+	if(memoryStream)
+	{
+		si64 position = memoryStream->tell();
+		if(size < 0 || size > memoryStream->getSize() - position)
+		{
+			throw std::runtime_error(getEndOfStreamExceptionMsg((long)size));
+		}
+		memoryStream->skip(size);
+		return memoryStream->getData() + position;
+	}
+
+	blockBuffer.resize(size);
+	read(blockBuffer.data(), size);
+	return blockBuffer.data();
+}
+
 template <typename CData>
 CData CBinaryReader::readInteger()
 {
@@ -10,6 +10,7 @@
 #pragma once
 
 class CInputStream;
+class CMemoryStream;
 
 /**
  * Reads primitive binary values from a underlying stream.
@@ -55,6 +56,19 @@ public:
 	 */
 	si64 read(ui8 * data, si64 size);
 
+	/**
+	 * Reads n bytes from the stream at once. Advances the read pointer.
+	 *
+	 * Data of memory stream is accessed directly, data of other streams is copied to internal buffer.
+	 * Returned pointer is valid until next call of this method or until the stream is changed.
+	 *
+	 * @param size The number of bytes to read.
+	 * @return a pointer to the read bytes.
+	 *
+	 * @throws std::runtime_error if the end of the stream was reached unexpectedly
+	 */
+	const ui8 * readBlock(si64 size);
+
 	/**
 	 * Reads integer of various size. Advances the read pointer.
 	 *
@@ -100,4 +114,10 @@ private:
 
 	/** The underlying base stream */
 	CInputStream * stream;
+
+	/** The underlying base stream if it is memory stream, nullptr otherwise */
+	CMemoryStream * memoryStream;
+
+	/** Storage for blocks read from streams which can't be accessed directly */
+	std::vector<ui8> blockBuffer;
 };
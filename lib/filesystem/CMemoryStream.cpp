@@ -10,6 +10,9 @@
 #include "StdInc.h"
 #include "CMemoryStream.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 CMemoryStream::CMemoryStream(const ui8 * data, si64 size) :
 	data(data), size(size), position(0)
 {
@@ -20,7 +23,7 @@ si64 CMemoryStream::read(ui8 * data, si64 size)
 {
 	si64 toRead = std::min(this->size - tell(), size);
 	std::copy(this->data + position, this->data + position + toRead, data);
-	position += size;
+	position += toRead;
 	return toRead;
 }
 
@@ -47,3 +50,36 @@ si64 CMemoryStream::getSize()
 {
 	return size;
 }
+
+const ui8 * CMemoryStream::getData() const
+{
+	return data;
+}
+
+CMappedFileStream::CMappedFileStream(TMapping mapping, size_t offset, si64 size) :
+	CMemoryStream(static_cast<const ui8 *>(mapping->get_address()) + offset, size),
+	mapping(std::move(mapping))
+{
+
+}
+
+CMappedFileStream::TMapping CMappedFileStream::mapFile(const boost::filesystem::path & file)
+{
+	if(sizeof(void *) < 8)
+		return nullptr;
+
+	boost::system::error_code error;
+	if(boost::filesystem::file_size(file, error) == 0 || error)
+		return nullptr;
+
+	try
+	{
+		boost::interprocess::file_mapping mappedFile(file.string().c_str(), boost::interprocess::read_only);
+		return std::make_shared<boost::interprocess::mapped_region>(mappedFile, boost::interprocess::read_only);
+	}
+	catch(boost::interprocess::interprocess_exception & e)
+	{
+		logGlobal->warn("Failed to map file %s: %s", file.string(), e.what());
+		return nullptr;
+	}
+}
@@ -11,6 +11,14 @@
 
 #include "CInputStream.h"
 
+namespace boost
+{
+namespace interprocess
+{
+	class mapped_region;
+}
+}
+
 /**
  * A class which provides method definitions for reading from memory.
  * @deprecated use CMemoryBuffer
@@ -65,6 +73,13 @@ public:
 	 */
 	si64 getSize() override;
 
+	/**
+	 * Gets the underlying data array. Allows to access data without copying.
+	 *
+	 * @return a pointer to the data array.
+	 */
+	const ui8 * getData() const;
+
 private:
 	/** A pointer to the data array. */
 	const ui8 * data;
@@ -75,3 +90,34 @@ private:
 	/** Current reading position of the stream. */
 	si64 position;
 };
+
+/**
+ * A class which provides method definitions for reading part of memory-mapped file.
+ * Keeps the mapping alive as long as the stream exists.
+ */
+class DLL_LINKAGE CMappedFileStream : public CMemoryStream
+{
+public:
+	typedef std::shared_ptr<const boost::interprocess::mapped_region> TMapping;
+
+	/**
+	 * C-tor.
+	 *
+	 * @param mapping The mapped file.
+	 * @param offset The offset of data in the file.
+	 * @param size The size of data in bytes.
+	 */
+	CMappedFileStream(TMapping mapping, size_t offset, si64 size);
+
+	/**
+	 * Maps whole file into memory for reading.
+	 * Files are not mapped on 32-bit platforms, because all game data does not fit into their address space.
+	 *
+	 * @param file The path to the file.
+	 * @return the mapping or nullptr if file is empty or can't be mapped.
+	 */
+	static TMapping mapFile(const boost::filesystem::path & file);
+
+private:
+	TMapping mapping;
+};
@@ -13,6 +13,129 @@
 
 #include "../ScopeGuard.h"
 
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace
+{
+	// Zip format signatures and compression methods
+	const ui32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+	const ui32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+	const ui32 END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+	const ui32 ZIP64_END_OF_DIRECTORY_SIGNATURE = 0x06064b50;
+	const ui32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+	const ui16 ZIP64_EXTRA_FIELD = 0x0001;
+	const ui16 METHOD_STORED = 0;
+	const ui16 METHOD_DEFLATED = 8;
+
+	const size_t LOCAL_HEADER_SIZE = 30;
+	const size_t CENTRAL_HEADER_SIZE = 46;
+	const size_t END_OF_DIRECTORY_SIZE = 22;
+	const size_t ZIP64_END_OF_DIRECTORY_SIZE = 56;
+	const size_t ZIP64_LOCATOR_SIZE = 20;
+
+	ui16 readLE16(const ui8 * data)
+	{
+		return static_cast<ui16>(data[0] | (data[1] << 8));
+	}
+
+	ui32 readLE32(const ui8 * data)
+	{
+		return readLE16(data) | (static_cast<ui32>(readLE16(data + 2)) << 16);
+	}
+
+	ui64 readLE64(const ui8 * data)
+	{
+		return readLE32(data) | (static_cast<ui64>(readLE32(data + 4)) << 32);
+	}
+
+	/// Stored file of mapped archive, read without copying
+	class CMappedZipStream : public CMappedFileStream
+	{
+		ui32 crc;
+	public:
+		CMappedZipStream(TMapping mapping, size_t offset, si64 size, ui32 crc):
+			CMappedFileStream(std::move(mapping), offset, size),
+			crc(crc)
+		{
+		}
+
+		ui32 calculateCRC32() override
+		{
+			return crc;
+		}
+	};
+
+	/// Deflated file of mapped archive, inflated on demand straight from mapping
+	class CMappedDeflateStream : public CBufferedStream
+	{
+		CMappedFileStream::TMapping mapping;
+		z_stream inflateState;
+		bool inflateEnded;
+		si64 fullSize;
+		ui32 crc;
+
+	public:
+		CMappedDeflateStream(CMappedFileStream::TMapping mapping, size_t offset, const ZipEntry & entry):
+			mapping(std::move(mapping)),
+			inflateState(),
+			inflateEnded(false),
+			fullSize(entry.fullSize),
+			crc(entry.crc)
+		{
+			inflateState.next_in = static_cast<Bytef *>(this->mapping->get_address()) + offset;
+			inflateState.avail_in = static_cast<uInt>(entry.compressedSize);
+
+			// zip archives contain raw deflate data without zlib header
+			if(inflateInit2(&inflateState, -MAX_WBITS) != Z_OK)
+				throw std::runtime_error("Failed to initialize inflate!");
+		}
+
+		~CMappedDeflateStream()
+		{
+			if(!inflateEnded)
+				inflateEnd(&inflateState);
+		}
+
+		si64 getSize() override
+		{
+			return fullSize;
+		}
+
+		ui32 calculateCRC32() override
+		{
+			return crc;
+		}
+
+	protected:
+		si64 readMore(ui8 * data, si64 size) override
+		{
+			if(inflateEnded)
+				return 0;
+
+			inflateState.next_out = data;
+			inflateState.avail_out = static_cast<uInt>(size);
+
+			// whole compressed data is available, so inflate either fills the buffer or reaches end of data
+			int ret = inflate(&inflateState, Z_NO_FLUSH);
+			si64 decompressed = size - inflateState.avail_out;
+
+			if(ret == Z_STREAM_END || ret == Z_BUF_ERROR)
+			{
+				inflateEnd(&inflateState);
+				inflateEnded = true;
+			}
+			else if(ret != Z_OK)
+			{
+				std::string message = inflateState.msg ? inflateState.msg : boost::lexical_cast<std::string>(ret);
+				inflateEnd(&inflateState);
+				inflateEnded = true;
+				throw std::runtime_error("Decompression error: " + message);
+			}
+			return decompressed;
+		}
+	};
+}
+
 CZipStream::CZipStream(std::shared_ptr<CIOApi> api, const boost::filesystem::path & archive, unz64_file_pos filepos)
 {
 	zlib_filefunc64_def zlibApi;
@@ -49,20 +172,173 @@ ui32 CZipStream::calculateCRC32()
 	return info.crc;
 }
 
+ZipEntry::ZipEntry():
+	position(),
+	mapped(false),
+	method(0),
+	crc(0),
+	compressedSize(0),
+	fullSize(0),
+	localHeaderOffset(0)
+{
+}
+
 ///CZipLoader
 CZipLoader::CZipLoader(const std::string & mountPoint, const boost::filesystem::path & archive, std::shared_ptr<CIOApi> api):
 	ioApi(api),
     zlibApi(ioApi->getApiStructure()),
     archiveName(archive),
-    mountPoint(mountPoint),
-    files(listFiles(mountPoint, archive))
+    mountPoint(mountPoint)
 {
+	// only archives from real filesystem can be mapped, proxy api is used for archives that are already in memory
+	if(std::dynamic_pointer_cast<CDefaultIOApi>(ioApi))
+		mapping = CMappedFileStream::mapFile(archive);
+
+	if(mapping && !listMappedFiles(mountPoint, files))
+	{
+		logGlobal->warn("Failed to read central directory of %s, falling back to minizip", archive.string());
+		mapping.reset();
+		files.clear();
+	}
+
+	if(!mapping)
+		files = listFiles(mountPoint, archive);
+
 	logGlobal->trace("Zip archive loaded, %d files found", files.size());
 }
 
-std::unordered_map<ResourceID, unz64_file_pos> CZipLoader::listFiles(const std::string & mountPoint, const boost::filesystem::path & archive)
+bool CZipLoader::listMappedFiles(const std::string & mountPoint, std::unordered_map<ResourceID, ZipEntry> & result) const
 {
-	std::unordered_map<ResourceID, unz64_file_pos> ret;
+	const ui8 * data = static_cast<const ui8 *>(mapping->get_address());
+	const ui64 size = mapping->get_size();
+
+	if(size < END_OF_DIRECTORY_SIZE)
+		return false;
+
+	// end of central directory record is followed only by comment of up to 64 KB
+	ui64 endPos = size - END_OF_DIRECTORY_SIZE;
+	const ui64 searchLimit = endPos > 0xffff ? endPos - 0xffff : 0;
+	while(readLE32(data + endPos) != END_OF_DIRECTORY_SIGNATURE)
+	{
+		if(endPos == searchLimit)
+			return false;
+		endPos--;
+	}
+
+	ui64 centralPos = endPos;
+	ui64 entriesCount = readLE16(data + endPos + 10);
+	ui64 directorySize = readLE32(data + endPos + 12);
+	ui64 directoryOffset = readLE32(data + endPos + 16);
+
+	if(entriesCount == 0xffff || directorySize == 0xffffffff || directoryOffset == 0xffffffff)
+	{
+		if(endPos < ZIP64_LOCATOR_SIZE || size < ZIP64_END_OF_DIRECTORY_SIZE)
+			return false;
+
+		const ui8 * locator = data + endPos - ZIP64_LOCATOR_SIZE;
+		if(readLE32(locator) != ZIP64_LOCATOR_SIGNATURE)
+			return false;
+
+		centralPos = readLE64(locator + 8);
+		if(centralPos > size - ZIP64_END_OF_DIRECTORY_SIZE || readLE32(data + centralPos) != ZIP64_END_OF_DIRECTORY_SIGNATURE)
+			return false;
+
+		entriesCount = readLE64(data + centralPos + 32);
+		directorySize = readLE64(data + centralPos + 40);
+		directoryOffset = readLE64(data + centralPos + 48);
+	}
+
+	// data prepended to archive (e.g. self-extracting archives) shifts all offsets, minizip accounts for it in the same way.
+	// Both values may come from 64-bit fields, so they are compared without adding them up
+	if(directorySize > centralPos || directoryOffset > centralPos - directorySize)
+		return false;
+	const ui64 bytesBefore = centralPos - directoryOffset - directorySize;
+
+	ui64 entryPos = directoryOffset + bytesBefore;
+	for(ui64 i = 0; i < entriesCount; i++)
+	{
+		if(entryPos + CENTRAL_HEADER_SIZE > centralPos)
+			return false;
+
+		const ui8 * header = data + entryPos;
+		if(readLE32(header) != CENTRAL_HEADER_SIGNATURE)
+			return false;
+
+		const ui16 flags = readLE16(header + 8);
+		const size_t nameLength = readLE16(header + 28);
+		const size_t extraLength = readLE16(header + 30);
+		const size_t commentLength = readLE16(header + 32);
+
+		if(entryPos + CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength > centralPos)
+			return false;
+
+		ZipEntry entry;
+		entry.position.pos_in_zip_directory = entryPos - bytesBefore;
+		entry.position.num_of_file = i;
+		entry.method = readLE16(header + 10);
+		entry.crc = readLE32(header + 16);
+		entry.compressedSize = readLE32(header + 20);
+		entry.fullSize = readLE32(header + 24);
+		entry.localHeaderOffset = readLE32(header + 42);
+
+		// large values are stored in zip64 extra field, in fixed order and only if they don't fit into header
+		const ui8 * extra = header + CENTRAL_HEADER_SIZE + nameLength;
+		const ui8 * extraEnd = extra + extraLength;
+		while(extra + 4 <= extraEnd)
+		{
+			const ui16 fieldID = readLE16(extra);
+			const ui8 * field = extra + 4;
+			const ui8 * fieldEnd = std::min(field + readLE16(extra + 2), extraEnd);
+
+			if(fieldID == ZIP64_EXTRA_FIELD)
+			{
+				for(ui64 * value : {&entry.fullSize, &entry.compressedSize, &entry.localHeaderOffset})
+				{
+					if(*value == 0xffffffff && field + 8 <= fieldEnd)
+					{
+						*value = readLE64(field);
+						field += 8;
+					}
+				}
+			}
+			extra = fieldEnd;
+		}
+		entry.localHeaderOffset += bytesBefore;
+
+		// encrypted files and unknown compression methods are left to minizip
+		entry.mapped = !(flags & 1) && (entry.method == METHOD_STORED || entry.method == METHOD_DEFLATED);
+
+		std::string filename(reinterpret_cast<const char *>(header + CENTRAL_HEADER_SIZE), nameLength);
+		result[ResourceID(mountPoint + filename)] = entry;
+
+		entryPos += CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+	}
+	return true;
+}
+
+si64 CZipLoader::getMappedDataOffset(const ZipEntry & entry) const
+{
+	const ui8 * data = static_cast<const ui8 *>(mapping->get_address());
+	const ui64 size = mapping->get_size();
+
+	if(entry.localHeaderOffset > size || size - entry.localHeaderOffset < LOCAL_HEADER_SIZE)
+		return -1;
+
+	const ui8 * header = data + entry.localHeaderOffset;
+	if(readLE32(header) != LOCAL_HEADER_SIGNATURE)
+		return -1;
+
+	// name and extra field of local header may differ from ones in central directory
+	const ui64 dataOffset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + readLE16(header + 26) + readLE16(header + 28);
+	if(dataOffset > size || size - dataOffset < entry.compressedSize)
+		return -1;
+
+	return static_cast<si64>(dataOffset);
+}
+
+std::unordered_map<ResourceID, ZipEntry> CZipLoader::listFiles(const std::string & mountPoint, const boost::filesystem::path & archive)
+{
+	std::unordered_map<ResourceID, ZipEntry> ret;
 
 	unzFile file = unzOpen2_64(archive.c_str(), &zlibApi);
 
@@ -83,7 +359,7 @@ std::unordered_map<ResourceID, unz64_file_pos> CZipLoader::listFiles(const std::
 			unzGetCurrentFileInfo64 (file, &info, filename.data(), (uLong)filename.size(), nullptr, 0, nullptr, 0);
 
 			std::string filenameString(filename.data(), filename.size());
-			unzGetFilePos64(file, &ret[ResourceID(mountPoint + filenameString)]);
+			unzGetFilePos64(file, &ret[ResourceID(mountPoint + filenameString)].position);
 		}
 		while (unzGoToNextFile(file) == UNZ_OK);
 	}
@@ -94,7 +370,24 @@ std::unordered_map<ResourceID, unz64_file_pos> CZipLoader::listFiles(const std::
 
 std::unique_ptr<CInputStream> CZipLoader::load(const ResourceID & resourceName) const
 {
-	return std::unique_ptr<CInputStream>(new CZipStream(ioApi, archiveName, files.at(resourceName)));
+	const ZipEntry & entry = files.at(resourceName);
+
+	if(mapping && entry.mapped)
+	{
+		si64 dataOffset = getMappedDataOffset(entry);
+		if(dataOffset >= 0)
+		{
+			if(entry.method == METHOD_STORED)
+				return make_unique<CMappedZipStream>(mapping, dataOffset, entry.compressedSize, entry.crc);
+
+			if(entry.compressedSize <= std::numeric_limits<uInt>::max())
+				return make_unique<CMappedDeflateStream>(mapping, dataOffset, entry);
+		}
+		else
+			logGlobal->warn("Entry %s has invalid header in archive %s", resourceName.getName(), archiveName.string());
+	}
+
+	return std::unique_ptr<CInputStream>(new CZipStream(ioApi, archiveName, entry.position));
 }
 
 bool CZipLoader::existsResource(const ResourceID & resourceName) const
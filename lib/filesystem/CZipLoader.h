@@ -13,6 +13,7 @@
 #include "CInputStream.h"
 #include "ResourceID.h"
 #include "CCompressedStream.h"
+#include "CMemoryStream.h"
 
 #include "MinizipExtensions.h"
 
@@ -37,6 +38,24 @@ protected:
 	si64 readMore(ui8 * data, si64 size) override;
 };
 
+/// Location of file in zip archive
+struct DLL_LINKAGE ZipEntry
+{
+	/// position of file for minizip
+	unz64_file_pos position;
+
+	/// true if file can be read directly from mapped archive
+	bool mapped;
+	ui16 method;
+	ui32 crc;
+	ui64 compressedSize;
+	ui64 fullSize;
+	/// offset of local file header from beginning of archive
+	ui64 localHeaderOffset;
+
+	ZipEntry();
+};
+
 class DLL_LINKAGE CZipLoader : public ISimpleResourceLoader
 {
 	std::shared_ptr<CIOApi> ioApi;
@@ -44,9 +63,18 @@ class DLL_LINKAGE CZipLoader : public ISimpleResourceLoader
 	boost::filesystem::path archiveName;
 	std::string mountPoint;
 
-	std::unordered_map<ResourceID, unz64_file_pos> files;
+	/// read-only mapping of archive, nullptr if archive is read through minizip
+	CMappedFileStream::TMapping mapping;
+
+	std::unordered_map<ResourceID, ZipEntry> files;
+
+	std::unordered_map<ResourceID, ZipEntry> listFiles(const std::string & mountPoint, const boost::filesystem::path &archive);
+
+	/// parses central directory of mapped archive, returns false if archive is not valid
+	bool listMappedFiles(const std::string & mountPoint, std::unordered_map<ResourceID, ZipEntry> & result) const;
 
-	std::unordered_map<ResourceID, unz64_file_pos> listFiles(const std::string & mountPoint, const boost::filesystem::path &archive);
+	/// returns offset of file data in mapped archive or -1 if local header is not valid
+	si64 getMappedDataOffset(const ZipEntry & entry) const;
 public:
 	CZipLoader(const std::string & mountPoint, const boost::filesystem::path & archive, std::shared_ptr<CIOApi> api = std::shared_ptr<CIOApi>(new CDefaultIOApi()));
 
@@ -232,8 +232,7 @@ CMapHeader::~CMapHeader()
 }
 
 CMap::CMap()
-	: checksum(0), grailPos(-1, -1, -1), grailRadius(0), terrain(nullptr),
-	guardingCreaturePositions(nullptr)
+	: checksum(0), grailPos(-1, -1, -1), grailRadius(0)
 {
 	allHeroes.resize(allowedHeroes.size());
 	allowedAbilities = VLC->skillh->getDefaultAllowed();
@@ -243,22 +242,6 @@ CMap::CMap()
 
 CMap::~CMap()
 {
-	if(terrain)
-	{
-		for (int i=0; i<width; i++)
-		{
-			for(int j=0; j<height; j++)
-			{
-				delete [] terrain[i][j];
-				delete [] guardingCreaturePositions[i][j];
-			}
-			delete [] terrain[i];
-			delete [] guardingCreaturePositions[i];
-		}
-		delete [] terrain;
-		delete [] guardingCreaturePositions;
-	}
-
 	for(auto obj : objects)
 		obj.dellNull();
 
@@ -270,6 +253,7 @@ CMap::~CMap()
 
 void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 {
+	objectIndex.remove(obj);
 	for(int fx=0; fx<obj->getWidth(); ++fx)
 	{
 		for(int fy=0; fy<obj->getHeight(); ++fy)
@@ -279,7 +263,7 @@ void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 			int zVal = obj->pos.z;
 			if(xVal>=0 && xVal<width && yVal>=0 && yVal<height)
 			{
-				TerrainTile & curt = terrain[xVal][yVal][zVal];
+				TerrainTile & curt = terrain[getTileIndex(int3(xVal, yVal, zVal))];
 				if(total || obj->visitableAt(xVal, yVal))
 				{
 					curt.visitableObjects -= obj;
@@ -297,6 +281,7 @@ void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 
 void CMap::addBlockVisTiles(CGObjectInstance * obj)
 {
+	bool placed = false;
 	for(int fx=0; fx<obj->getWidth(); ++fx)
 	{
 		for(int fy=0; fy<obj->getHeight(); ++fy)
@@ -306,35 +291,70 @@ void CMap::addBlockVisTiles(CGObjectInstance * obj)
 			int zVal = obj->pos.z;
 			if(xVal>=0 && xVal<width && yVal>=0 && yVal<height)
 			{
-				TerrainTile & curt = terrain[xVal][yVal][zVal];
+				TerrainTile & curt = terrain[getTileIndex(int3(xVal, yVal, zVal))];
 				if( obj->visitableAt(xVal, yVal))
 				{
 					curt.visitableObjects.push_back(obj);
 					curt.visitable = true;
+					placed = true;
 				}
 				if( obj->blockingAt(xVal, yVal))
 				{
 					curt.blockingObjects.push_back(obj);
 					curt.blocked = true;
+					placed = true;
 				}
 			}
 		}
 	}
+
+	if(placed)
+		objectIndex.add(obj);
+}
+
+void CMap::rebuildObjectIndex()
+{
+	objectIndex.reset(int3(width, height, twoLevel ? 2 : 1));
+
+	std::vector<bool> placed(objects.size(), false);
+	auto markPlaced = [&placed](const CGObjectInstance * obj)
+	{
+		if(obj->id.getNum() >= 0 && obj->id.getNum() < static_cast<si32>(placed.size()))
+			placed[obj->id.getNum()] = true;
+	};
+	for(auto & tile : terrain)
+	{
+		boost::for_each(tile.visitableObjects, markPlaced);
+		boost::for_each(tile.blockingObjects, markPlaced);
+	}
+
+	// objects are added in order of their ids, so every insertion goes to the end of lists
+	for(size_t i = 0; i < objects.size(); i++)
+	{
+		if(placed[i] && objects[i])
+			objectIndex.add(objects[i]);
+	}
 }
 
 void CMap::calculateGuardingGreaturePositions()
 {
 	int levels = twoLevel ? 2 : 1;
-	for (int i=0; i<width; i++)
+	for (int k = 0; k < levels; k++)
 	{
 		for(int j=0; j<height; j++)
 		{
-			for (int k = 0; k < levels; k++)
-				guardingCreaturePositions[i][j][k] = guardingCreaturePosition(int3(i,j,k));
+			for (int i=0; i<width; i++)
+				guardingCreaturePositions[getTileIndex(int3(i,j,k))] = guardingCreaturePosition(int3(i,j,k));
 		}
 	}
 }
 
+const int3 & CMap::getGuardingCreaturePosition(const int3 & pos) const
+{
+	assert(isInTheMap(pos));
+	return guardingCreaturePositions[getTileIndex(pos)];
+}
+
 CGHeroInstance * CMap::getHero(int heroID)
 {
 	for(auto & elem : heroesOnMap)
@@ -385,16 +405,21 @@ bool CMap::isInTheMap(const int3 & pos) const
 	}
 }
 
+size_t CMap::getTileIndex(const int3 & tile) const
+{
+	return (static_cast<size_t>(tile.z) * height + tile.y) * width + tile.x;
+}
+
 TerrainTile & CMap::getTile(const int3 & tile)
 {
 	assert(isInTheMap(tile));
-	return terrain[tile.x][tile.y][tile.z];
+	return terrain[getTileIndex(tile)];
 }
 
 const TerrainTile & CMap::getTile(const int3 & tile) const
 {
 	assert(isInTheMap(tile));
-	return terrain[tile.x][tile.y][tile.z];
+	return terrain[getTileIndex(tile)];
 }
 
 bool CMap::isWaterTile(const int3 &pos) const
@@ -624,19 +649,10 @@ void CMap::addNewObject(CGObjectInstance * obj)
 
 void CMap::initTerrain()
 {
-	int level = twoLevel ? 2 : 1;
-	terrain = new TerrainTile**[width];
-	guardingCreaturePositions = new int3**[width];
-	for (int i = 0; i < width; ++i)
-	{
-		terrain[i] = new TerrainTile*[height];
-		guardingCreaturePositions[i] = new int3*[height];
-		for (int j = 0; j < height; ++j)
-		{
-			terrain[i][j] = new TerrainTile[level];
-			guardingCreaturePositions[i][j] = new int3[level];
-		}
-	}
+	const size_t tilesCount = static_cast<size_t>(width) * height * (twoLevel ? 2 : 1);
+	terrain.assign(tilesCount, TerrainTile());
+	guardingCreaturePositions.assign(tilesCount, int3());
+	objectIndex.reset(int3(width, height, twoLevel ? 2 : 1));
 }
 
 CMapEditManager * CMap::getEditManager()
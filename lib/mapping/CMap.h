@@ -19,6 +19,7 @@
 #include "../GameConstants.h"
 #include "../LogicalExpression.h"
 #include "CMapDefines.h"
+#include "CMapObjectIndex.h"
 
 class CArtifactInstance;
 class CGObjectInstance;
@@ -363,9 +364,15 @@ public:
 	bool canMoveBetween(const int3 &src, const int3 &dst) const;
 	bool checkForVisitableDir( const int3 & src, const TerrainTile *pom, const int3 & dst ) const;
 	int3 guardingCreaturePosition (int3 pos) const;
+	/// same as guardingCreaturePosition, but precomputed by calculateGuardingGreaturePositions
+	const int3 & getGuardingCreaturePosition(const int3 & pos) const;
 
+	/// places object on its tiles and into objectIndex
 	void addBlockVisTiles(CGObjectInstance * obj);
+	/// removes object from its tiles and from objectIndex
 	void removeBlockVisTiles(CGObjectInstance * obj, bool total = false);
+	/// fills objectIndex with all objects placed on tiles, needed when types or owners were changed without updating it
+	void rebuildObjectIndex();
 	void calculateGuardingGreaturePositions();
 
 	void addNewArtifactInstance(CArtifactInstance * art);
@@ -405,6 +412,7 @@ public:
 
 	//Helper lists
 	std::vector< ConstTransitivePtr<CGHeroInstance> > heroesOnMap;
+	CMapObjectIndex objectIndex; //objects placed on tiles, not serialized
 	std::map<TeleportChannelID, std::shared_ptr<TeleportChannel> > teleportChannels;
 
 	/// associative list to identify which hero/creature id belongs to which object id(index for objects)
@@ -412,13 +420,15 @@ public:
 
 	std::unique_ptr<CMapEditManager> editManager;
 
-	int3 ***guardingCreaturePositions;
-
 	std::map<std::string, ConstTransitivePtr<CGObjectInstance> > instanceNames;
 
 private:
-	/// a 3-dimensional array of terrain tiles, access is as follows: x, y, level. where level=1 is underground
-	TerrainTile*** terrain;
+	/// index of tile in terrain and guardingCreaturePositions, tiles are stored level by level, row by row
+	size_t getTileIndex(const int3 & tile) const;
+
+	/// all terrain tiles in one block, see getTileIndex. Level 1 is underground
+	std::vector<TerrainTile> terrain;
+	std::vector<int3> guardingCreaturePositions;
 
 public:
 	template <typename Handler>
@@ -437,45 +447,26 @@ public:
 		h & questIdentifierToId;
 
 		//TODO: viccondetails
-		int level = twoLevel ? 2 : 1;
-		if(h.saving)
+		if(formatVersion >= 796)
 		{
-			// Save terrain
-			for(int i = 0; i < width ; ++i)
-			{
-				for(int j = 0; j < height ; ++j)
-				{
-					for(int k = 0; k < level; ++k)
-					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
-					}
-				}
-			}
+			h & terrain;
+			h & guardingCreaturePositions;
 		}
 		else
 		{
-			// Load terrain
-			terrain = new TerrainTile**[width];
-			guardingCreaturePositions = new int3**[width];
-			for(int i = 0; i < width; ++i)
-			{
-				terrain[i] = new TerrainTile*[height];
-				guardingCreaturePositions[i] = new int3*[height];
-				for(int j = 0; j < height; ++j)
-				{
-					terrain[i][j] = new TerrainTile[level];
-					guardingCreaturePositions[i][j] = new int3[level];
-				}
-			}
+			// old saves store tiles column by column, together with their guards
+			if(!h.saving)
+				initTerrain();
+
+			int level = twoLevel ? 2 : 1;
 			for(int i = 0; i < width ; ++i)
 			{
 				for(int j = 0; j < height ; ++j)
 				{
 					for(int k = 0; k < level; ++k)
 					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
+						h & terrain[getTileIndex(int3(i, j, k))];
+						h & guardingCreaturePositions[getTileIndex(int3(i, j, k))];
 					}
 				}
 			}
@@ -499,5 +490,8 @@ public:
 		{
 			h & instanceNames;
 		}
+
+		if(!h.saving)
+			rebuildObjectIndex();
 	}
 };
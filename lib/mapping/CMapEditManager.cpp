@@ -10,7 +10,7 @@
 #include "StdInc.h"
 #include "CMapEditManager.h"
 
-#include "../JsonNode.h"
+#include "../JsonView.h"
 #include "../filesystem/Filesystem.h"
 #include "../mapObjects/CObjectClassesHandler.h"
 #include "../mapObjects/CGHeroInstance.h"
@@ -353,21 +353,23 @@ void TerrainViewPattern::WeightedRule::setNative()
 
 CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 {
-	const JsonNode config(ResourceID("config/terrainViewPatterns.json"));
+	const JsonTree configTree(ResourceID("config/terrainViewPatterns.json"));
+	const JsonView config = configTree.root();
 	static const std::string patternTypes[] = { "terrainView", "terrainType" };
 	for(int i = 0; i < ARRAY_COUNT(patternTypes); ++i)
 	{
-		const auto & patternsVec = config[patternTypes[i]].Vector();
-		for(const auto & ptrnNode : patternsVec)
+		const JsonView patternsVec = config[patternTypes[i]];
+		for(size_t k = 0; k < patternsVec.size(); ++k)
 		{
+			const JsonView ptrnNode = patternsVec[k];
 			TerrainViewPattern pattern;
 
 			// Read pattern data
-			const JsonVector & data = ptrnNode["data"].Vector();
+			const JsonView data = ptrnNode["data"];
 			assert(data.size() == 9);
 			for(int j = 0; j < data.size(); ++j)
 			{
-				std::string cell = data[j].String();
+				std::string cell = data[j].String().to_string();
 				boost::algorithm::erase_all(cell, " ");
 				std::vector<std::string> rules;
 				boost::split(rules, cell, boost::is_any_of(","));
@@ -386,7 +388,7 @@ CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 			}
 
 			// Read various properties
-			pattern.id = ptrnNode["id"].String();
+			pattern.id = ptrnNode["id"].String().to_string();
 			assert(!pattern.id.empty());
 			pattern.minPoints = static_cast<int>(ptrnNode["minPoints"].Float());
 			pattern.maxPoints = static_cast<int>(ptrnNode["maxPoints"].Float());
@@ -395,11 +397,11 @@ CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 			// Read mapping
 			if(i == 0)
 			{
-				const auto & mappingStruct = ptrnNode["mapping"].Struct();
-				for(const auto & mappingPair : mappingStruct)
+				const JsonView mappingStruct = ptrnNode["mapping"];
+				for(size_t m = 0; m < mappingStruct.size(); ++m)
 				{
 					TerrainViewPattern terGroupPattern = pattern;
-					auto mappingStr = mappingPair.second.String();
+					auto mappingStr = mappingStruct[m].String().to_string();
 					boost::algorithm::erase_all(mappingStr, " ");
 					auto colonIndex = mappingStr.find_first_of(":");
 					const auto & flipMode = mappingStr.substr(0, colonIndex);
@@ -421,7 +423,7 @@ CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 					}
 
 					// Add pattern to the patterns map
-					const auto & terGroup = getTerrainGroup(mappingPair.first);
+					const auto & terGroup = getTerrainGroup(mappingStruct.keyAt(m));
 					std::vector<TerrainViewPattern> terrainViewPatternFlips;
 					terrainViewPatternFlips.push_back(terGroupPattern);
 
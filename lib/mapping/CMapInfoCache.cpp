@@ -0,0 +1,201 @@
+/*
+ * CMapInfoCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CMapInfoCache.h"
+
+#include "CMapInfo.h"
+#include "../filesystem/Filesystem.h"
+#include "../serializer/BinaryDeserializer.h"
+#include "../serializer/BinarySerializer.h"
+#include "../serializer/CMemorySerializer.h"
+#include "../CCreatureHandler.h"
+#include "../CHeroHandler.h"
+#include "../CModHandler.h"
+#include "../CThreadHelper.h"
+#include "../StartInfo.h"
+#include "../rmg/CMapGenOptions.h"
+#include "../VCMI_Lib.h"
+
+static const std::string MAP_INFO_CACHE_MAGIC = "VCMIMHC";
+
+CMapInfoCache::Entry::Entry()
+	: size(0), modified(0)
+{
+}
+
+CMapInfoCache::CMapInfoCache(const boost::filesystem::path & file)
+	: file(file), changed(false)
+{
+	if(!boost::filesystem::exists(file))
+		return;
+
+	try
+	{
+		CLoadFile cache(file);
+		cache.checkMagicBytes(MAP_INFO_CACHE_MAGIC);
+
+		std::string key;
+		cache >> key;
+		if(key != getCacheKey())
+		{
+			logGlobal->info("Map header cache is outdated");
+			changed = true;
+			return;
+		}
+		cache >> entries;
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->warn("Failed to load map header cache %s: %s", file.string(), e.what());
+		entries.clear();
+		changed = true;
+	}
+}
+
+CMapInfoCache::~CMapInfoCache() = default;
+
+std::string CMapInfoCache::getCacheKey()
+{
+	// map headers refer to heroes, artifacts and other objects by their indexes that depend on content of loaded mods
+	return VLC->modh->getContentCacheKey().toJson(true);
+}
+
+std::vector<std::shared_ptr<CMapInfo>> CMapInfoCache::load(const std::unordered_set<ResourceID> & files, const TInitFunction & init)
+{
+	struct Request
+	{
+		const ResourceID * resource;
+		std::string path; //empty if file is not located in real filesystem and can't be cached
+		Entry entry;
+		bool cached;
+		std::shared_ptr<CMapInfo> result;
+	};
+
+	std::vector<Request> requests;
+	requests.reserve(files.size());
+
+	for(auto & resource : files)
+	{
+		Request request;
+		request.resource = &resource;
+		request.cached = false;
+
+		auto path = CResourceHandler::get()->getResourceName(resource);
+		boost::system::error_code sizeError, timeError;
+		if(path)
+		{
+			request.entry.size = boost::filesystem::file_size(*path, sizeError);
+			request.entry.modified = boost::filesystem::last_write_time(*path, timeError);
+		}
+
+		if(path && !sizeError && !timeError)
+		{
+			request.path = path->string();
+			auto entry = entries.find(request.path);
+			if(entry != entries.end() && entry->second.size == request.entry.size && entry->second.modified == request.entry.modified)
+			{
+				request.entry.info = entry->second.info;
+				request.cached = true;
+			}
+		}
+		requests.push_back(request);
+	}
+
+	std::vector<Task> tasks;
+	tasks.reserve(requests.size());
+	for(auto & request : requests)
+	{
+		tasks.push_back([&request, &init]()
+		{
+			if(!request.cached)
+			{
+				try
+				{
+					auto info = std::make_shared<CMapInfo>();
+					init(*info, *request.resource);
+					request.entry.info = info;
+				}
+				catch(std::exception & e)
+				{
+					logGlobal->error("File %s is invalid. Message: %s", request.resource->getName(), e.what());
+				}
+			}
+
+			// caller gets its own copy, so cached entry can't be changed from outside
+			if(request.entry.info)
+				request.result = std::shared_ptr<CMapInfo>(CMemorySerializer::deepCopy(*request.entry.info));
+		});
+	}
+
+	const int threads = std::max<int>(1, boost::thread::hardware_concurrency());
+	CThreadHelper helper(&tasks, std::min<int>(threads, static_cast<int>(tasks.size())));
+	if(!tasks.empty())
+		helper.run();
+
+	std::vector<std::shared_ptr<CMapInfo>> result;
+	result.reserve(requests.size());
+	for(auto & request : requests)
+	{
+		if(!request.cached && !request.path.empty())
+		{
+			entries[request.path] = request.entry;
+			changed = true;
+		}
+		if(request.result)
+			result.push_back(request.result);
+	}
+
+	logGlobal->debug("Loaded %d headers, %d of them parsed", result.size(), boost::count_if(requests, [](const Request & request)
+	{
+		return !request.cached;
+	}));
+	return result;
+}
+
+void CMapInfoCache::save()
+{
+	// forget files that were removed
+	for(auto entry = entries.begin(); entry != entries.end();)
+	{
+		boost::system::error_code error;
+		if(!boost::filesystem::exists(entry->first, error))
+		{
+			entry = entries.erase(entry);
+			changed = true;
+		}
+		else
+			entry++;
+	}
+
+	if(!changed)
+		return;
+
+	//several processes may start at once, write to temporary file and replace cache in one step
+	auto tempFile = file;
+	tempFile += boost::filesystem::unique_path(".%%%%-%%%%").string();
+
+	try
+	{
+		{
+			CSaveFile cache(tempFile);
+			cache.putMagicBytes(MAP_INFO_CACHE_MAGIC);
+			cache << getCacheKey();
+			cache << entries;
+		}
+		boost::filesystem::rename(tempFile, file);
+		changed = false;
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->warn("Failed to save map header cache %s: %s", file.string(), e.what());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempFile, ec);
+	}
+}
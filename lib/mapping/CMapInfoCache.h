@@ -0,0 +1,63 @@
+/*
+ * CMapInfoCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../filesystem/ResourceID.h"
+
+class CMapInfo;
+
+/**
+ * Persistent cache of headers of maps, campaigns and saved games shown in lobby.
+ * Entries are keyed by path of file and reused as long as size and modification time of file are same.
+ */
+class DLL_LINKAGE CMapInfoCache
+{
+public:
+	typedef std::function<void(CMapInfo &, const ResourceID &)> TInitFunction;
+
+	/**
+	 * Loads cache from file. Cache is empty if file is missing
+	 * or was written by different version of game or with different set of mods.
+	 */
+	explicit CMapInfoCache(const boost::filesystem::path & file);
+	~CMapInfoCache();
+
+	/**
+	 * Returns headers of all files. Only new or changed files are parsed by init function, on multiple threads.
+	 * Files that can't be parsed are skipped. Returned objects are not shared with cache and can be modified.
+	 */
+	std::vector<std::shared_ptr<CMapInfo>> load(const std::unordered_set<ResourceID> & files, const TInitFunction & init);
+
+	/// Writes cache to disk if any entry was changed
+	void save();
+
+private:
+	struct Entry
+	{
+		ui64 size;
+		si64 modified;
+		std::shared_ptr<CMapInfo> info; //nullptr if file can't be parsed
+
+		Entry();
+
+		template <typename Handler> void serialize(Handler & h, const int version)
+		{
+			h & size;
+			h & modified;
+			h & info;
+		}
+	};
+
+	static std::string getCacheKey();
+
+	boost::filesystem::path file;
+	std::map<std::string, Entry> entries;
+	bool changed;
+};
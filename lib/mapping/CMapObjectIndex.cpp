@@ -0,0 +1,200 @@
+/*
+ * CMapObjectIndex.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CMapObjectIndex.h"
+
+#include "../mapObjects/CObjectHandler.h"
+
+static const int CELL_SIZE = 8;
+
+/// value moved into range [0, limit)
+static int clampTo(int value, int limit)
+{
+	return std::max(0, std::min(value, limit - 1));
+}
+
+static bool compareIds(const CGObjectInstance * lhs, const CGObjectInstance * rhs)
+{
+	return lhs->id < rhs->id;
+}
+
+static void insertSorted(std::vector<CGObjectInstance *> & list, CGObjectInstance * obj)
+{
+	list.insert(std::lower_bound(list.begin(), list.end(), obj, compareIds), obj);
+}
+
+static void eraseSorted(std::vector<CGObjectInstance *> & list, const CGObjectInstance * obj)
+{
+	auto it = std::lower_bound(list.begin(), list.end(), obj, compareIds);
+	assert(it != list.end() && *it == obj);
+	if(it != list.end() && *it == obj)
+		list.erase(it);
+}
+
+CMapObjectIndex::Entry::Entry()
+	: object(nullptr)
+{
+}
+
+CMapObjectIndex::CMapObjectIndex()
+{
+}
+
+void CMapObjectIndex::reset(const int3 & mapSize)
+{
+	this->mapSize = mapSize;
+	cellsCount = int3((mapSize.x + CELL_SIZE - 1) / CELL_SIZE, (mapSize.y + CELL_SIZE - 1) / CELL_SIZE, mapSize.z);
+
+	cells.clear();
+	cells.resize(static_cast<size_t>(cellsCount.x) * cellsCount.y * cellsCount.z);
+	objectsByType.clear();
+	objectsByOwner.clear();
+	entries.clear();
+}
+
+void CMapObjectIndex::add(CGObjectInstance * obj)
+{
+	if(cells.empty() || obj->id.getNum() < 0)
+		return;
+
+	const size_t index = obj->id.getNum();
+	if(index >= entries.size())
+		entries.resize(index + 1);
+	else if(entries[index].object)
+		removeEntry(index); //either obj itself or object which id was given to obj
+
+	Entry & entry = entries[index];
+	entry.object = obj;
+	entry.position = getPosition(obj);
+	entry.type = obj->ID;
+	entry.owner = obj->tempOwner;
+
+	insertSorted(cells[getCell(entry.position)], obj);
+	insertSorted(objectsByType[entry.type], obj);
+	insertSorted(objectsByOwner[entry.owner], obj);
+}
+
+void CMapObjectIndex::remove(const CGObjectInstance * obj)
+{
+	if(contains(obj))
+		removeEntry(obj->id.getNum());
+}
+
+void CMapObjectIndex::update(CGObjectInstance * obj)
+{
+	if(contains(obj))
+		add(obj);
+}
+
+bool CMapObjectIndex::contains(const CGObjectInstance * obj) const
+{
+	const si32 index = obj->id.getNum();
+	return index >= 0 && index < static_cast<si32>(entries.size()) && entries[index].object == obj;
+}
+
+std::vector<CGObjectInstance *> CMapObjectIndex::getObjectsInRect(const int3 & topLeft, const int3 & bottomRight) const
+{
+	std::vector<CGObjectInstance *> ret;
+	foreachCell(topLeft, bottomRight, [&](const std::vector<CGObjectInstance *> & cell)
+	{
+		for(auto obj : cell)
+		{
+			const int3 & position = entries[obj->id.getNum()].position;
+			if(position.x >= topLeft.x && position.x <= bottomRight.x && position.y >= topLeft.y && position.y <= bottomRight.y)
+				ret.push_back(obj);
+		}
+	});
+	boost::sort(ret, compareIds);
+	return ret;
+}
+
+std::vector<CGObjectInstance *> CMapObjectIndex::getObjectsWithin(const int3 & tile, ui32 distanceSQ) const
+{
+	// smallest square containing the circle
+	const int radius = static_cast<int>(std::sqrt(static_cast<double>(distanceSQ)));
+	const int3 offset(radius, radius, 0);
+
+	std::vector<CGObjectInstance *> ret;
+	foreachCell(tile - offset, tile + offset, [&](const std::vector<CGObjectInstance *> & cell)
+	{
+		for(auto obj : cell)
+		{
+			if(tile.dist2dSQ(entries[obj->id.getNum()].position) <= distanceSQ)
+				ret.push_back(obj);
+		}
+	});
+	boost::sort(ret, compareIds);
+	return ret;
+}
+
+const std::vector<CGObjectInstance *> & CMapObjectIndex::getObjectsOfType(Obj type) const
+{
+	static const std::vector<CGObjectInstance *> empty;
+	auto it = objectsByType.find(type);
+	return it != objectsByType.end() ? it->second : empty;
+}
+
+const std::vector<CGObjectInstance *> & CMapObjectIndex::getObjectsOfOwner(PlayerColor owner) const
+{
+	static const std::vector<CGObjectInstance *> empty;
+	auto it = objectsByOwner.find(owner);
+	return it != objectsByOwner.end() ? it->second : empty;
+}
+
+std::vector<CGObjectInstance *> CMapObjectIndex::getAllObjects() const
+{
+	std::vector<CGObjectInstance *> ret;
+	for(auto & entry : entries)
+	{
+		if(entry.object)
+			ret.push_back(entry.object);
+	}
+	return ret;
+}
+
+void CMapObjectIndex::removeEntry(size_t index)
+{
+	Entry & entry = entries[index];
+	eraseSorted(cells[getCell(entry.position)], entry.object);
+	eraseSorted(objectsByType[entry.type], entry.object);
+	eraseSorted(objectsByOwner[entry.owner], entry.object);
+	entry = Entry();
+}
+
+int3 CMapObjectIndex::getPosition(const CGObjectInstance * obj)
+{
+	return obj->isVisitable() ? obj->visitablePos() : obj->pos;
+}
+
+size_t CMapObjectIndex::getCell(const int3 & position) const
+{
+	// objects may stick out of the map, they are kept in the nearest cell
+	const int x = clampTo(position.x, mapSize.x) / CELL_SIZE;
+	const int y = clampTo(position.y, mapSize.y) / CELL_SIZE;
+	const int z = clampTo(position.z, mapSize.z);
+	return (static_cast<size_t>(z) * cellsCount.y + y) * cellsCount.x + x;
+}
+
+void CMapObjectIndex::foreachCell(const int3 & topLeft, const int3 & bottomRight, const std::function<void(const std::vector<CGObjectInstance *> &)> & handler) const
+{
+	if(cells.empty() || topLeft.z < 0 || topLeft.z >= mapSize.z)
+		return;
+
+	// cells on the map border also hold objects sticking out of the map
+	const int3 first(clampTo(topLeft.x, mapSize.x) / CELL_SIZE, clampTo(topLeft.y, mapSize.y) / CELL_SIZE, topLeft.z);
+	const int3 last(clampTo(bottomRight.x, mapSize.x) / CELL_SIZE, clampTo(bottomRight.y, mapSize.y) / CELL_SIZE, topLeft.z);
+
+	for(int y = first.y; y <= last.y; y++)
+	{
+		for(int x = first.x; x <= last.x; x++)
+			handler(cells[(static_cast<size_t>(first.z) * cellsCount.y + y) * cellsCount.x + x]);
+	}
+}
@@ -0,0 +1,68 @@
+/*
+ * CMapObjectIndex.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+#include "../GameConstants.h"
+
+class CGObjectInstance;
+
+/// Index of objects placed on map tiles: buckets of square cells of the map and lists by type and owner.
+/// Position of object is its visitable tile, or its bottom right tile if it can't be visited.
+/// All lists and query results are sorted by object instance id, so iterating them is deterministic.
+class DLL_LINKAGE CMapObjectIndex
+{
+public:
+	CMapObjectIndex();
+
+	/// removes all objects, mapSize is (width, height, levels) of the map
+	void reset(const int3 & mapSize);
+
+	/// adds object, or moves it to its current position, type and owner if it is already present.
+	/// Other object indexed with the same instance id is removed
+	void add(CGObjectInstance * obj);
+	void remove(const CGObjectInstance * obj);
+	/// same as add, but objects that are not present are ignored
+	void update(CGObjectInstance * obj);
+	bool contains(const CGObjectInstance * obj) const;
+
+	/// objects with position in rectangle between both corners, corners included. Only level of topLeft is searched
+	std::vector<CGObjectInstance *> getObjectsInRect(const int3 & topLeft, const int3 & bottomRight) const;
+	/// objects on the same level with position in int3::dist2dSQ from tile not greater than distanceSQ
+	std::vector<CGObjectInstance *> getObjectsWithin(const int3 & tile, ui32 distanceSQ) const;
+	const std::vector<CGObjectInstance *> & getObjectsOfType(Obj type) const;
+	const std::vector<CGObjectInstance *> & getObjectsOfOwner(PlayerColor owner) const;
+	std::vector<CGObjectInstance *> getAllObjects() const;
+
+private:
+	struct Entry
+	{
+		Entry();
+
+		CGObjectInstance * object; //nullptr if no object with this id is present
+		int3 position;
+		Obj type;
+		PlayerColor owner;
+	};
+
+	void removeEntry(size_t index);
+	static int3 getPosition(const CGObjectInstance * obj);
+	size_t getCell(const int3 & position) const;
+	/// calls handler for every cell overlapping rectangle, corners are clamped to the map
+	void foreachCell(const int3 & topLeft, const int3 & bottomRight, const std::function<void(const std::vector<CGObjectInstance *> &)> & handler) const;
+
+	int3 mapSize;
+	int3 cellsCount;
+	std::vector<std::vector<CGObjectInstance *>> cells; //level by level, row by row
+	std::map<Obj, std::vector<CGObjectInstance *>> objectsByType;
+	std::map<PlayerColor, std::vector<CGObjectInstance *>> objectsByOwner;
+	std::vector<Entry> entries; //indexed by object instance id
+};
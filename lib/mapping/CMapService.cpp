@@ -15,6 +15,7 @@
 #include "../filesystem/CCompressedStream.h"
 #include "../filesystem/CMemoryStream.h"
 #include "../filesystem/CMemoryBuffer.h"
+#include "../JsonView.h"
 
 #include "CMap.h"
 
@@ -129,12 +130,11 @@ static JsonNode loadPatches(std::string path)
 
 std::unique_ptr<IMapPatcher> CMapService::getMapPatcher(std::string scenarioName)
 {
-	static JsonNode node;
-
-	if (node.isNull())
-		node = loadPatches("config/mapOverrides.json");
+	// kept for whole session in compact form, only patch of requested map is converted back.
+	// Headers are loaded on multiple threads, initialization of local static is thread-safe
+	static const JsonTree patches(loadPatches("config/mapOverrides.json"));
 
 	boost::to_lower(scenarioName);
 	logGlobal->debug("Request to patch map %s", scenarioName);
-	return std::unique_ptr<IMapPatcher>(new CMapPatcher(node[scenarioName]));
+	return std::unique_ptr<IMapPatcher>(new CMapPatcher(patches.root()[scenarioName].toJsonNode()));
 }
@@ -0,0 +1,423 @@
+/*
+ * CTileSet.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CTileSet.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static const size_t WORD_BITS = 64;
+
+static int countTrailingZeros(ui64 word)
+{
+	assert(word);
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long result;
+	_BitScanForward64(&result, word);
+	return static_cast<int>(result);
+#else
+	int result = 0;
+	while(!(word & 1))
+	{
+		word >>= 1;
+		result++;
+	}
+	return result;
+#endif
+}
+
+static int highestBit(ui64 word)
+{
+	assert(word);
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long result;
+	_BitScanReverse64(&result, word);
+	return static_cast<int>(result);
+#else
+	int result = 0;
+	while(word >>= 1)
+		result++;
+	return result;
+#endif
+}
+
+static size_t countBits(ui64 word)
+{
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+}
+
+CTileSet::const_iterator::const_iterator()
+	: set(nullptr), index(0)
+{
+}
+
+CTileSet::const_iterator::const_iterator(const CTileSet * set, size_t index)
+	: set(set), index(index)
+{
+}
+
+int3 CTileSet::const_iterator::dereference() const
+{
+	return set->getTile(index);
+}
+
+bool CTileSet::const_iterator::equal(const const_iterator & other) const
+{
+	return index == other.index;
+}
+
+void CTileSet::const_iterator::increment()
+{
+	index = set->findNext(index + 1, set->tilesCount);
+}
+
+void CTileSet::const_iterator::decrement()
+{
+	index = set->findPrevious(index, 0);
+	assert(index != set->tilesCount); //decrementing begin()
+}
+
+CTileSet::CTileSet()
+	: mapSize(0, 0, 0), tilesCount(0), count(0)
+{
+}
+
+CTileSet::CTileSet(const int3 & mapSize)
+	: mapSize(mapSize), count(0)
+{
+	tilesCount = static_cast<size_t>(mapSize.x) * mapSize.y * mapSize.z;
+	bits.resize((tilesCount + WORD_BITS - 1) / WORD_BITS, 0);
+}
+
+const int3 & CTileSet::getMapSize() const
+{
+	return mapSize;
+}
+
+bool CTileSet::isInside(const int3 & tile) const
+{
+	return tile.x >= 0 && tile.y >= 0 && tile.z >= 0 && tile.x < mapSize.x && tile.y < mapSize.y && tile.z < mapSize.z;
+}
+
+size_t CTileSet::getIndex(const int3 & tile) const
+{
+	//same order as int3::operator<
+	return (static_cast<size_t>(tile.z) * mapSize.y + tile.y) * mapSize.x + tile.x;
+}
+
+int3 CTileSet::getTile(size_t index) const
+{
+	const size_t levelSize = static_cast<size_t>(mapSize.x) * mapSize.y;
+	const size_t inLevel = index % levelSize;
+	return int3(static_cast<si32>(inLevel % mapSize.x), static_cast<si32>(inLevel / mapSize.x), static_cast<si32>(index / levelSize));
+}
+
+bool CTileSet::insert(const int3 & tile)
+{
+	if(!isInside(tile))
+		return false;
+
+	const size_t index = getIndex(tile);
+	ui64 & word = bits[index / WORD_BITS];
+	const ui64 mask = 1ULL << (index % WORD_BITS);
+	if(word & mask)
+		return false;
+
+	word |= mask;
+	count++;
+	return true;
+}
+
+bool CTileSet::erase(const int3 & tile)
+{
+	if(!contains(tile))
+		return false;
+
+	const size_t index = getIndex(tile);
+	bits[index / WORD_BITS] &= ~(1ULL << (index % WORD_BITS));
+	count--;
+	return true;
+}
+
+bool CTileSet::contains(const int3 & tile) const
+{
+	if(!isInside(tile))
+		return false;
+
+	const size_t index = getIndex(tile);
+	return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+void CTileSet::clear()
+{
+	std::fill(bits.begin(), bits.end(), 0);
+	count = 0;
+}
+
+size_t CTileSet::size() const
+{
+	return count;
+}
+
+bool CTileSet::empty() const
+{
+	return count == 0;
+}
+
+CTileSet::const_iterator CTileSet::begin() const
+{
+	return const_iterator(this, findNext(0, tilesCount));
+}
+
+CTileSet::const_iterator CTileSet::end() const
+{
+	return const_iterator(this, tilesCount);
+}
+
+size_t CTileSet::findNext(size_t index, size_t limit) const
+{
+	if(index >= limit)
+		return limit;
+
+	size_t wordIndex = index / WORD_BITS;
+	const size_t lastWord = (limit - 1) / WORD_BITS;
+	ui64 word = bits[wordIndex] & (~0ULL << (index % WORD_BITS));
+
+	while(!word)
+	{
+		if(wordIndex == lastWord)
+			return limit;
+		word = bits[++wordIndex];
+	}
+
+	const size_t result = wordIndex * WORD_BITS + countTrailingZeros(word);
+	return result < limit ? result : limit;
+}
+
+size_t CTileSet::findPrevious(size_t index, size_t limit) const
+{
+	if(index <= limit)
+		return tilesCount;
+
+	index--;
+	size_t wordIndex = index / WORD_BITS;
+	const size_t firstWord = limit / WORD_BITS;
+	const size_t bit = index % WORD_BITS;
+	ui64 word = bits[wordIndex] & (bit == WORD_BITS - 1 ? ~0ULL : ((1ULL << (bit + 1)) - 1));
+
+	while(!word)
+	{
+		if(wordIndex == firstWord)
+			return tilesCount;
+		word = bits[--wordIndex];
+	}
+
+	const size_t result = wordIndex * WORD_BITS + highestBit(word);
+	return result >= limit ? result : tilesCount;
+}
+
+void CTileSet::updateCount()
+{
+	count = 0;
+	for(auto word : bits)
+		count += countBits(word);
+}
+
+std::vector<ui64> CTileSet::getUsedWords(ui32 & firstWord) const
+{
+	auto isUsed = [](ui64 word)
+	{
+		return word != 0;
+	};
+	auto first = std::find_if(bits.begin(), bits.end(), isUsed);
+	auto last = std::find_if(bits.rbegin(), bits.rend(), isUsed).base();
+
+	firstWord = static_cast<ui32>(first - bits.begin());
+	if(first >= last)
+		return std::vector<ui64>();
+	return std::vector<ui64>(first, last);
+}
+
+void CTileSet::setUsedWords(ui32 firstWord, const std::vector<ui64> & words)
+{
+	//size is read from save or pack, so it is checked before anything is allocated
+	const int3 size = mapSize;
+	*this = CTileSet();
+	if(size.x < 0 || size.y < 0 || size.z < 0 || size.x > MAX_MAP_WIDTH || size.y > MAX_MAP_WIDTH || size.z > MAX_MAP_LEVELS)
+		throw std::runtime_error("Invalid size of map in tile set: " + size.toString());
+
+	const size_t wordsCount = (static_cast<size_t>(size.x) * size.y * size.z + WORD_BITS - 1) / WORD_BITS;
+	if(!words.empty() && (firstWord > wordsCount || words.size() > wordsCount - firstWord))
+		throw std::runtime_error("Tile set does not fit into map of size " + size.toString());
+
+	*this = CTileSet(size);
+	if(words.empty())
+		return;
+
+	std::copy(words.begin(), words.end(), bits.begin() + firstWord);
+	if(tilesCount % WORD_BITS) //bits past the last tile must stay empty
+		bits.back() &= (1ULL << (tilesCount % WORD_BITS)) - 1;
+	updateCount();
+}
+
+CTileSet & CTileSet::operator|=(const CTileSet & other)
+{
+	assert(mapSize == other.mapSize || other.bits.empty());
+	for(size_t i = 0; i < std::min(bits.size(), other.bits.size()); i++)
+		bits[i] |= other.bits[i];
+	updateCount();
+	return *this;
+}
+
+CTileSet & CTileSet::operator&=(const CTileSet & other)
+{
+	assert(mapSize == other.mapSize || other.bits.empty());
+	for(size_t i = 0; i < bits.size(); i++)
+		bits[i] &= i < other.bits.size() ? other.bits[i] : 0;
+	updateCount();
+	return *this;
+}
+
+CTileSet & CTileSet::operator-=(const CTileSet & other)
+{
+	assert(mapSize == other.mapSize || other.bits.empty());
+	for(size_t i = 0; i < std::min(bits.size(), other.bits.size()); i++)
+		bits[i] &= ~other.bits[i];
+	updateCount();
+	return *this;
+}
+
+bool CTileSet::intersects(const CTileSet & other) const
+{
+	assert(mapSize == other.mapSize || bits.empty() || other.bits.empty());
+	for(size_t i = 0; i < std::min(bits.size(), other.bits.size()); i++)
+	{
+		if(bits[i] & other.bits[i])
+			return true;
+	}
+	return false;
+}
+
+int3 CTileSet::findClosest(const int3 & tile) const
+{
+	int3 result(-1, -1, -1);
+	if(empty())
+		return result;
+
+	ui32 bestDistance = std::numeric_limits<ui32>::max();
+	auto check = [&](size_t index)
+	{
+		if(index == tilesCount)
+			return;
+		const int3 candidate = getTile(index);
+		const ui32 distance = tile.dist2dSQ(candidate);
+		if(distance < bestDistance || (distance == bestDistance && candidate < result))
+		{
+			bestDistance = distance;
+			result = candidate;
+		}
+	};
+
+	//tiles on rows closer to given tile are checked first, on every row only closest tile from left and right side is needed
+	const int x = std::min(std::max(tile.x, 0), mapSize.x - 1);
+	const int maxRowDistance = std::max(std::abs(tile.y), std::abs(tile.y - (mapSize.y - 1)));
+	for(int rowDistance = 0; rowDistance <= maxRowDistance; rowDistance++)
+	{
+		if(static_cast<ui32>(rowDistance) * rowDistance > bestDistance)
+			break;
+
+		for(int y : {tile.y - rowDistance, tile.y + rowDistance})
+		{
+			if(y < 0 || y >= mapSize.y)
+				continue;
+
+			for(int z = 0; z < mapSize.z; z++)
+			{
+				const size_t rowStart = getIndex(int3(0, y, z));
+				const size_t rowEnd = rowStart + mapSize.x;
+				const size_t right = findNext(rowStart + x, rowEnd);
+				if(right != rowEnd)
+					check(right);
+				check(findPrevious(rowStart + x, rowStart));
+			}
+			if(!rowDistance)
+				break;
+		}
+	}
+	return result;
+}
+
+template<typename Handler>
+void CTileSet::foreachRowWithin(const int3 & tile, ui32 distanceSQ, Handler handler) const
+{
+	const int radius = static_cast<int>(std::sqrt(static_cast<double>(distanceSQ))) + 1;
+	for(int y = std::max(0, tile.y - radius); y <= std::min(mapSize.y - 1, tile.y + radius); y++)
+	{
+		const ui32 dy = static_cast<ui32>(std::abs(y - tile.y));
+		if(dy * dy > distanceSQ)
+			continue;
+
+		int dx = static_cast<int>(std::sqrt(static_cast<double>(distanceSQ - dy * dy))) + 1;
+		while(static_cast<ui32>(dx * dx) + dy * dy > distanceSQ) //sqrt may be rounded either way
+			dx--;
+
+		const int minX = std::max(0, tile.x - dx);
+		const int maxX = std::min(mapSize.x - 1, tile.x + dx);
+		if(minX > maxX)
+			continue;
+
+		for(int z = 0; z < mapSize.z; z++)
+		{
+			const size_t rowStart = getIndex(int3(0, y, z));
+			if(!handler(rowStart + minX, rowStart + maxX + 1))
+				return;
+		}
+	}
+}
+
+bool CTileSet::hasTileWithin(const int3 & tile, ui32 distanceSQ) const
+{
+	bool result = false;
+	foreachRowWithin(tile, distanceSQ, [&](size_t first, size_t limit)
+	{
+		result = findNext(first, limit) != limit;
+		return !result;
+	});
+	return result;
+}
+
+void CTileSet::foreachTileWithin(const int3 & tile, ui32 distanceSQ, const std::function<void(const int3 &)> & handler) const
+{
+	foreachRowWithin(tile, distanceSQ, [&](size_t first, size_t limit)
+	{
+		for(size_t index = findNext(first, limit); index != limit; index = findNext(index + 1, limit))
+			handler(getTile(index));
+		return true;
+	});
+}
+
+bool CTileSet::operator==(const CTileSet & other) const
+{
+	return mapSize == other.mapSize && bits == other.bits;
+}
+
+bool CTileSet::operator!=(const CTileSet & other) const
+{
+	return !(*this == other);
+}
@@ -0,0 +1,120 @@
+/*
+ * CTileSet.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+#include <boost/iterator/iterator_facade.hpp>
+
+/// Set of map tiles stored as bitmap covering whole map.
+/// Tiles are visited in same order as in std::set<int3>, erasing tiles does not invalidate iterators.
+/// Tiles outside of the map are never part of the set and are ignored by insert.
+class DLL_LINKAGE CTileSet
+{
+public:
+	typedef int3 value_type;
+
+	class DLL_LINKAGE const_iterator : public boost::iterator_facade<const_iterator, const int3, boost::bidirectional_traversal_tag, int3>
+	{
+	public:
+		const_iterator();
+		const_iterator(const CTileSet * set, size_t index);
+
+	private:
+		friend class boost::iterator_core_access;
+
+		int3 dereference() const;
+		bool equal(const const_iterator & other) const;
+		void increment();
+		void decrement();
+
+		const CTileSet * set;
+		size_t index;
+	};
+	typedef const_iterator iterator;
+
+	/// largest map size accepted when loading set, bigger sizes come only from corrupted data
+	static const si32 MAX_MAP_WIDTH = 1024;
+	static const si32 MAX_MAP_LEVELS = 2;
+
+	CTileSet();
+	/// mapSize is (width, height, levels) of the map
+	explicit CTileSet(const int3 & mapSize);
+
+	const int3 & getMapSize() const;
+
+	/// returns true if tile was not present before
+	bool insert(const int3 & tile);
+	/// returns true if tile was present
+	bool erase(const int3 & tile);
+	bool contains(const int3 & tile) const;
+	void clear();
+
+	size_t size() const;
+	bool empty() const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/// union, intersection and difference of sets with same size of map, default-constructed set may be used as empty operand
+	CTileSet & operator|=(const CTileSet & other);
+	CTileSet & operator&=(const CTileSet & other);
+	CTileSet & operator-=(const CTileSet & other);
+	bool intersects(const CTileSet & other) const;
+
+	/// closest tile by int3::dist2dSQ on any level, or invalid tile if set is empty.
+	/// From tiles with same distance returns first one, same as findClosestTile
+	int3 findClosest(const int3 & tile) const;
+	/// true if any tile of set is in int3::dist2dSQ not greater than distanceSQ
+	bool hasTileWithin(const int3 & tile, ui32 distanceSQ) const;
+	/// calls handler for tiles of set in int3::dist2dSQ not greater than distanceSQ, only rows and words inside of this circle are visited
+	void foreachTileWithin(const int3 & tile, ui32 distanceSQ, const std::function<void(const int3 &)> & handler) const;
+
+	bool operator==(const CTileSet & other) const;
+	bool operator!=(const CTileSet & other) const;
+
+	template <typename Handler> void serialize(Handler & h, const int version)
+	{
+		//only words between first and last non-empty one are stored, so sets covering small area stay small
+		ui32 firstWord = 0;
+		std::vector<ui64> words;
+		if(h.saving)
+			words = getUsedWords(firstWord);
+
+		h & mapSize;
+		h & firstWord;
+		h & words;
+
+		if(!h.saving)
+			setUsedWords(firstWord, words);
+	}
+
+private:
+	bool isInside(const int3 & tile) const;
+	size_t getIndex(const int3 & tile) const;
+	int3 getTile(size_t index) const;
+
+	/// first tile in range [index, limit), or limit if there is none
+	size_t findNext(size_t index, size_t limit) const;
+	/// last tile in range [limit, index), or total count of tiles if there is none
+	size_t findPrevious(size_t index, size_t limit) const;
+	/// calls handler(first, limit) with index range of every row part inside of the circle, until handler returns false
+	template<typename Handler>
+	void foreachRowWithin(const int3 & tile, ui32 distanceSQ, Handler handler) const;
+	void updateCount();
+	std::vector<ui64> getUsedWords(ui32 & firstWord) const;
+	/// resets set to current mapSize and fills it from words, throws if size is out of limits or words don't fit
+	void setUsedWords(ui32 firstWord, const std::vector<ui64> & words);
+
+	int3 mapSize;
+	size_t tilesCount; //width * height * levels
+	size_t count;
+	std::vector<ui64> bits;
+};
@@ -58,20 +58,18 @@ std::unique_ptr<CMapHeader> CMapLoaderH3M::loadMapHeader()
 
 void CMapLoaderH3M::init()
 {
-	//FIXME: get rid of double input process
-	si64 temp_size = inputStream->getSize();
+	mapData.resize(inputStream->getSize());
 	inputStream->seek(0);
-
-	auto  temp_buffer = new ui8[temp_size];
-	inputStream->read(temp_buffer,temp_size);
+	mapData.resize(inputStream->read(mapData.data(), mapData.size()));
 
 	// Compute checksum
 	boost::crc_32_type  result;
-	result.process_bytes(temp_buffer, temp_size);
+	result.process_bytes(mapData.data(), mapData.size());
 	map->checksum = result.checksum();
 
-	delete [] temp_buffer;
-	inputStream->seek(0);
+	// map is already decompressed, parse it from memory instead of inflating it again field by field
+	mapDataStream = make_unique<CMemoryStream>(mapData.data(), mapData.size());
+	reader.setStream(mapDataStream.get());
 
 	CStopWatch sw;
 
@@ -921,18 +919,22 @@ void CMapLoaderH3M::readTerrain()
 			break;
 		}
 
+		// each tile takes 7 bytes, read whole level at once
+		const int tileSize = 7;
+		const ui8 * tileData = reader.readBlock(static_cast<si64>(map->width) * map->height * tileSize);
+
 		for(int c = 0; c < map->width; c++)
 		{
-			for(int z = 0; z < map->height; z++)
+			for(int z = 0; z < map->height; z++, tileData += tileSize)
 			{
 				auto & tile = map->getTile(int3(z, c, a));
-				tile.terType = ETerrainType(reader.readUInt8());
-				tile.terView = reader.readUInt8();
-				tile.riverType = static_cast<ERiverType::ERiverType>(reader.readUInt8());
-				tile.riverDir = reader.readUInt8();
-				tile.roadType = static_cast<ERoadType::ERoadType>(reader.readUInt8());
-				tile.roadDir = reader.readUInt8();
-				tile.extTileFlags = reader.readUInt8();
+				tile.terType = ETerrainType(tileData[0]);
+				tile.terView = tileData[1];
+				tile.riverType = static_cast<ERiverType::ERiverType>(tileData[2]);
+				tile.riverDir = tileData[3];
+				tile.roadType = static_cast<ERoadType::ERoadType>(tileData[4]);
+				tile.roadDir = tileData[5];
+				tile.extTileFlags = tileData[6];
 				tile.blocked = ((tile.terType == ETerrainType::ROCK || tile.terType == ETerrainType::BORDER ) ? true : false); //underground tiles are always blocked
 				tile.visitable = 0;
 			}
@@ -2198,9 +2200,10 @@ void CMapLoaderH3M::readBitmask(std::set<Indentifier>& dest, const int byteCount
 
 void CMapLoaderH3M::readBitmask(std::vector<bool>& dest, const int byteCount, const int limit, bool negate)
 {
+	const ui8 * masks = reader.readBlock(byteCount);
 	for(int byte = 0; byte < byteCount; ++byte)
 	{
-		const ui8 mask = reader.readUInt8();
+		const ui8 mask = masks[byte];
 		for(int bit = 0; bit < 8; ++bit)
 		{
 			if(byte * 8 + bit < limit)
@@ -18,6 +18,7 @@
 #include "../int3.h"
 
 #include "../filesystem/CBinaryReader.h"
+#include "../filesystem/CMemoryStream.h"
 
 class CGHeroInstance;
 class CArtifactInstance;
@@ -259,4 +260,8 @@ private:
 	CBinaryReader reader;
 	CInputStream * inputStream;
 
+	/** whole decompressed map, map is parsed from memory after checksum is computed */
+	std::vector<ui8> mapData;
+	std::unique_ptr<CMemoryStream> mapDataStream;
+
 };
@@ -313,6 +313,7 @@ void registerTypesClientPacks2(Serializer &s)
 
 	s.template registerType<CPackForClient, SaveGameClient>();
 	s.template registerType<CPackForClient, PlayerMessageClient>();
+	s.template registerType<CPackForClient, GameStateDigest>();
 }
 
 template<typename Serializer>
@@ -18,6 +18,7 @@
 #include "../StringConstants.h"
 #include "../filesystem/Filesystem.h"
 #include "CZonePlacer.h"
+#include "../CThreadHelper.h"
 #include "CRmgTemplateZone.h"
 #include "../mapObjects/CObjectClassesHandler.h"
 
@@ -60,7 +61,7 @@ void CMapGenerator::foreachDiagonaltNeighbour(const int3& pos, std::function<voi
 CMapGenerator::CMapGenerator() :
 	mapGenOptions(nullptr), randomSeed(0), editManager(nullptr),
 	zonesTotal(0), tiles(nullptr), prisonsRemaining(0),
-    monolithIndex(0)
+    monolithIndex(0), threadsCount(0)
 {
 }
 
@@ -135,6 +136,8 @@ std::unique_ptr<CMap> CMapGenerator::generate(CMapGenOptions * mapGenOptions, in
 
 	map = make_unique<CMap>();
 	editManager = map->getEditManager();
+	phaseTimes.clear();
+	phaseStart = std::chrono::steady_clock::now();
 
 	try
 	{
@@ -145,8 +148,10 @@ std::unique_ptr<CMap> CMapGenerator::generate(CMapGenOptions * mapGenOptions, in
 
 		initPrisonsRemaining();
 		initQuestArtsRemaining();
+		finishPhase("initialization");
 		genZones();
 		map->calculateGuardingGreaturePositions(); //clear map so that all tiles are unguarded
+		finishPhase("zone placement");
 		fillZones();
 		//updated guarded tiles will be calculated in CGameState::initMapObjects()
 		zones.clear();
@@ -158,6 +163,65 @@ std::unique_ptr<CMap> CMapGenerator::generate(CMapGenOptions * mapGenOptions, in
 	return std::move(map);
 }
 
+void CMapGenerator::finishPhase(const std::string & name)
+{
+	auto now = std::chrono::steady_clock::now();
+	si64 time = std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count();
+	phaseTimes.push_back(std::make_pair(name, time));
+	phaseStart = now;
+	logGlobal->debug("RMG phase %s took %d ms", name, time);
+}
+
+const std::vector<std::pair<std::string, si64>> & CMapGenerator::getPhaseTimes() const
+{
+	return phaseTimes;
+}
+
+void CMapGenerator::setThreadsCount(int count)
+{
+	threadsCount = count;
+}
+
+int CMapGenerator::getThreadsCount() const
+{
+	if (threadsCount > 0)
+		return threadsCount;
+	return std::max<int>(1, boost::thread::hardware_concurrency());
+}
+
+void CMapGenerator::runTasks(std::vector<Task> & tasks) const
+{
+	if (tasks.empty())
+		return;
+
+	// exceptions can not leave worker threads, pass first of them to calling thread
+	boost::mutex mx;
+	std::exception_ptr error;
+	std::vector<Task> guardedTasks;
+	for (auto & task : tasks)
+	{
+		guardedTasks.push_back([&]()
+		{
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				boost::unique_lock<boost::mutex> lock(mx);
+				if (!error)
+					error = std::current_exception();
+			}
+		});
+	}
+
+	CThreadHelper helper(&guardedTasks, std::min<int>(getThreadsCount(), static_cast<int>(guardedTasks.size())));
+	helper.run();
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
 std::string CMapGenerator::getMapDescription() const
 {
 	assert(mapGenOptions);
@@ -287,10 +351,13 @@ void CMapGenerator::genZones()
 		zones[zone->getId()] = zone;
 		//todo: move to CRmgTemplateZone constructor
 		zone->setGenPtr(this);//immediately set gen pointer before taking any actions on zones
+		//random stream of zone is derived only from map seed and zone id
+		zone->setRandomSeed(static_cast<int>(static_cast<ui32>(randomSeed) ^ (static_cast<ui32>(zone->getId()) * 0x9E3779B9u)));
 	}
 
 	CZonePlacer placer(this);
-	placer.placeZones(mapGenOptions, &rand);
+	//fixed number of attempts, so same seed gives same map on any machine
+	placer.placeZones(mapGenOptions, &rand, 4);
 	placer.assignZones(mapGenOptions);
 
 	logGlobal->info("Zones generated successfully");
@@ -322,6 +389,19 @@ void CMapGenerator::fillZones()
 
 	createConnections2(); //subterranean gates and monoliths
 
+	//paths use only tiles of their own zone and random generator of zone, so result is same for any number of threads
+	std::vector<Task> tasks;
+	for (auto it : zones)
+	{
+		auto zone = it.second;
+		tasks.push_back([zone]()
+		{
+			zone->createPaths();
+		});
+	}
+	runTasks(tasks);
+	finishPhase("connections");
+
 	std::vector<std::shared_ptr<CRmgTemplateZone>> treasureZones;
 	for (auto it : zones)
 	{
@@ -329,6 +409,7 @@ void CMapGenerator::fillZones()
 		if (it.second->getType() == ETemplateZoneType::TREASURE)
 			treasureZones.push_back(it.second);
 	}
+	finishPhase("filling zones");
 
 	//set apriopriate free/occupied tiles, including blocked underground rock
 	createObstaclesCommon1();
@@ -341,6 +422,7 @@ void CMapGenerator::fillZones()
 	{
 		it.second->createObstacles2();
 	}
+	finishPhase("obstacles");
 
 	#define PRINT_MAP_BEFORE_ROADS false
 	if (PRINT_MAP_BEFORE_ROADS) //enable to debug
@@ -381,6 +463,7 @@ void CMapGenerator::fillZones()
 	{
 		it.second->connectRoads(); //draw roads after everything else has been placed
 	}
+	finishPhase("roads");
 
 	//find place for Grail
 	if (treasureZones.empty())
@@ -506,14 +589,10 @@ void CMapGenerator::createDirectConnections()
 		auto zoneA = zones[connection.getZoneA()];
 		auto zoneB = zones[connection.getZoneB()];
 
-		//rearrange tiles in random order
-		auto tilesCopy = zoneA->getTileInfo();
-		std::vector<int3> tiles(tilesCopy.begin(), tilesCopy.end());
+		const CTileSet & tilesA = zoneA->getTileInfo();
 
 		int3 guardPos(-1,-1,-1);
 
-		auto otherZoneTiles = zoneB->getTileInfo();
-
 		int3 posA = zoneA->getPos();
 		int3 posB = zoneB->getPos();
 		// auto zoneAid = zoneA->getId();
@@ -522,7 +601,7 @@ void CMapGenerator::createDirectConnections()
 		if (posA.z == posB.z)
 		{
 			std::vector<int3> middleTiles;
-			for (auto tile : tilesCopy)
+			for (auto tile : tilesA)
 			{
 				if (isBlocked(tile)) //tiles may be occupied by subterranean gates already placed
 					continue;
@@ -606,8 +685,8 @@ void CMapGenerator::createConnections2()
 			{
 				bool continueOuterLoop = false;
 				//find common tiles for both zones
-				auto tileSetA = zoneA->getPossibleTiles(),
-					tileSetB = zoneB->getPossibleTiles();
+				const CTileSet & tileSetA = zoneA->getPossibleTiles();
+				const CTileSet & tileSetB = zoneB->getPossibleTiles();
 
 				std::vector<int3> tilesA(tileSetA.begin(), tileSetA.end()),
 					tilesB(tileSetB.begin(), tileSetB.end());
@@ -784,6 +863,11 @@ CTileInfo CMapGenerator::getTile(const int3& tile) const
 	return tiles[tile.x][tile.y][tile.z];
 }
 
+int3 CMapGenerator::getMapSize() const
+{
+	return int3(map->width, map->height, map->twoLevel ? 2 : 1);
+}
+
 TRmgTemplateZoneId CMapGenerator::getZoneID(const int3& tile) const
 {
 	checkIsOnMap(tile);
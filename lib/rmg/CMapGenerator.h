@@ -64,6 +64,14 @@ public:
 	CMapEditManager * editManager;
 
 	Zones & getZones();
+
+	/// wall time of generation phases of last map in milliseconds, in order of execution
+	const std::vector<std::pair<std::string, si64>> & getPhaseTimes() const;
+	/// maximum number of threads used by generation, 0 means number of hardware threads. Map is the same for any value
+	void setThreadsCount(int count);
+	int getThreadsCount() const;
+	/// runs tasks on up to getThreadsCount() threads, first exception thrown by any task is rethrown on calling thread
+	void runTasks(std::vector<std::function<void()>> & tasks) const;
 	void createDirectConnections();
 	void createConnections2();
 	void findZonesForQuestArts();
@@ -82,6 +90,7 @@ public:
 	void setRoad(const int3 &tile, ERoadType::ERoadType roadType);
 
 	CTileInfo getTile(const int3 & tile) const;
+	int3 getMapSize() const; //(width, height, levels)
 	bool isAllowedSpell(SpellID sid) const;
 
 	float getNearestObjectDistance(const int3 &tile) const;
@@ -113,6 +122,9 @@ private:
 	//int questArtsRemaining;
 	int monolithIndex;
 	std::vector<ArtifactID> questArtifacts;
+	std::vector<std::pair<std::string, si64>> phaseTimes;
+	int threadsCount;
+	std::chrono::steady_clock::time_point phaseStart;
 	void checkIsOnMap(const int3 &tile) const; //throws
 
 	/// Generation methods
@@ -127,5 +139,7 @@ private:
 	void fillZones();
 	void createObstaclesCommon1();
 	void createObstaclesCommon2();
+	/// records time since end of previous phase
+	void finishPhase(const std::string & name);
 
 };
@@ -19,6 +19,11 @@ using namespace rmg;
 
 const std::map<std::string, CRmgTemplate *> & CRmgTemplateStorage::getTemplates() const
 {
+	//container is never modified after it is built, so reference is safe to use without lock
+	boost::call_once(templatesLoaded, [this]()
+	{
+		loadPendingTemplates();
+	});
 	return templates;
 }
 
@@ -30,23 +35,48 @@ void CRmgTemplateStorage::loadObject(std::string scope, std::string name, const
 
 void CRmgTemplateStorage::loadObject(std::string scope, std::string name, const JsonNode & data)
 {
-	auto tpl = new CRmgTemplate();
-	try
+	boost::unique_lock<boost::mutex> lock(mx);
+	if(pendingLoaded)
 	{
-		JsonDeserializer handler(nullptr, data);
-		auto fullKey = normalizeIdentifier(scope, "core", name);
-		tpl->setId(name);
-		tpl->serializeJson(handler);
-		tpl->validate();
-		templates[fullKey] = tpl;
+		logGlobal->error("Template %s is loaded after templates were used, ignoring it", name);
+		return;
 	}
-	catch(const std::exception & e)
+	auto fullKey = normalizeIdentifier(scope, "core", name);
+	PendingTemplate & pending = pendingTemplates[fullKey];
+	pending.name = name;
+	pending.data = data;
+}
+
+void CRmgTemplateStorage::loadPendingTemplates() const
+{
+	std::map<std::string, PendingTemplate> toLoad;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		std::swap(toLoad, pendingTemplates);
+		pendingLoaded = true;
+	}
+
+	for(auto & pending : toLoad)
 	{
-		logGlobal->error("Template %s has errors. Message: %s.", tpl->getName(), std::string(e.what()));
+		auto tpl = new CRmgTemplate();
+		try
+		{
+			JsonDeserializer handler(nullptr, pending.second.data);
+			tpl->setId(pending.second.name);
+			tpl->serializeJson(handler);
+			tpl->validate();
+			templates[pending.first] = tpl;
+		}
+		catch(const std::exception & e)
+		{
+			logGlobal->error("Template %s has errors. Message: %s.", tpl->getName(), std::string(e.what()));
+			delete tpl;
+		}
 	}
 }
 
 CRmgTemplateStorage::CRmgTemplateStorage()
+	: templatesLoaded(), pendingLoaded(false)
 {
 }
 
@@ -11,17 +11,19 @@
 #pragma once
 
 #include "../IHandlerBase.h"
+#include "../JsonNode.h"
 
-class JsonNode;
 class CRmgTemplate;
 
 /// The CJsonRmgTemplateLoader loads templates from a JSON file.
+/// Templates are needed only for random maps, so they are kept as json and deserialized on first access
 class DLL_LINKAGE CRmgTemplateStorage : public IHandlerBase
 {
 public:
 	CRmgTemplateStorage();
 	~CRmgTemplateStorage();
 
+	/// returns all valid templates, deserializes them on first call. Templates loaded after that are ignored
 	const std::map<std::string, CRmgTemplate *> & getTemplates() const;
 
 	std::vector<bool> getDefaultAllowed() const override;
@@ -32,6 +34,20 @@ public:
 	virtual void loadObject(std::string scope, std::string name, const JsonNode & data, size_t index) override;
 
 private:
-	std::map<std::string, CRmgTemplate *> templates;
+	struct PendingTemplate
+	{
+		std::string name;
+		JsonNode data;
+	};
+
+	void loadPendingTemplates() const;
+
+	/// guards pendingTemplates and pendingLoaded, templates are written only once under templatesLoaded
+	mutable boost::mutex mx;
+	mutable boost::once_flag templatesLoaded;
+	/// templates that were not deserialized yet
+	mutable std::map<std::string, PendingTemplate> pendingTemplates;
+	mutable bool pendingLoaded;
+	mutable std::map<std::string, CRmgTemplate *> templates;
 };
 
@@ -36,6 +36,14 @@ void CRmgTemplateZone::addRoadNode(const int3& node)
 	roadNodes.insert(node);
 }
 
+CTreasurePileInfo::CTreasurePileInfo(const int3 & mapSize)
+	: visitableFromBottomPositions(mapSize),
+	visitableFromTopPositions(mapSize),
+	blockedPositions(mapSize),
+	occupiedPositions(mapSize)
+{
+}
+
 CTileInfo::CTileInfo():nearestObjectDistance(float(INT_MAX)), terrain(ETerrainType::WRONG),roadType(ERoadType::NO_ROAD)
 {
 	occupied = ETileType::POSSIBLE; //all tiles are initially possible to place objects or passages
@@ -122,6 +130,15 @@ void CRmgTemplateZone::setOptions(const ZoneOptions * options)
 void CRmgTemplateZone::setGenPtr(CMapGenerator * Gen)
 {
 	gen = Gen;
+
+	const int3 mapSize = gen->getMapSize();
+	for(auto tiles : {&tileinfo, &possibleTiles, &freePaths, &roadNodes, &roads, &tilesToConnectLater})
+		*tiles = CTileSet(mapSize);
+}
+
+void CRmgTemplateZone::setRandomSeed(int seed)
+{
+	rand.setSeed(seed);
 }
 
 void CRmgTemplateZone::setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZone)
@@ -129,7 +146,7 @@ void CRmgTemplateZone::setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZo
 	questArtZone = otherZone;
 }
 
-std::set<int3>* CRmgTemplateZone::getFreePaths()
+CTileSet * CRmgTemplateZone::getFreePaths()
 {
 	return &freePaths;
 }
@@ -142,16 +159,22 @@ void CRmgTemplateZone::setCenter(const float3 &f)
 {
 	//limit boundaries to (0,1) square
 
+	center = wrapCenter(f);
+}
+
+float3 CRmgTemplateZone::wrapCenter(const float3 &f)
+{
 	//alternate solution - wrap zone around unitary square. If it doesn't fit on one side, will come out on the opposite side
-	center = f;
+	float3 result = f;
 
-	center.x = static_cast<float>(std::fmod(center.x, 1));
-	center.y = static_cast<float>(std::fmod(center.y, 1));
+	result.x = static_cast<float>(std::fmod(result.x, 1));
+	result.y = static_cast<float>(std::fmod(result.y, 1));
 
-	if (center.x < 0) //fmod seems to work only for positive numbers? we want to stay positive
-		center.x = 1 - std::abs(center.x);
-	if (center.y < 0)
-		center.y = 1 - std::abs(center.y);
+	if (result.x < 0) //fmod seems to work only for positive numbers? we want to stay positive
+		result.x = 1 - std::abs(result.x);
+	if (result.y < 0)
+		result.y = 1 - std::abs(result.y);
+	return result;
 }
 
 
@@ -174,11 +197,11 @@ void CRmgTemplateZone::addTile (const int3 &pos)
 	tileinfo.insert(pos);
 }
 
-std::set<int3> CRmgTemplateZone::getTileInfo () const
+const CTileSet & CRmgTemplateZone::getTileInfo () const
 {
 	return tileinfo;
 }
-std::set<int3> CRmgTemplateZone::getPossibleTiles() const
+const CTileSet & CRmgTemplateZone::getPossibleTiles() const
 {
 	return possibleTiles;
 }
@@ -195,10 +218,11 @@ void CRmgTemplateZone::discardDistantTiles (float distance)
 	//		//gen->setOccupied(tile, ETileType::BLOCKED); //fixme: crash at rendering?
 	//	}
 	//}
-	vstd::erase_if (tileinfo, [distance, this](const int3 &tile) -> bool
+	for (auto tile : tileinfo)
 	{
-		return tile.dist2d(this->pos) > distance;
-	});
+		if (tile.dist2d(this->pos) > distance)
+			tileinfo.erase(tile);
+	}
 }
 
 void CRmgTemplateZone::clearTiles()
@@ -208,10 +232,14 @@ void CRmgTemplateZone::clearTiles()
 
 void CRmgTemplateZone::initFreeTiles ()
 {
-	vstd::copy_if (tileinfo, vstd::set_inserter(possibleTiles), [this](const int3 &tile) -> bool
+	for (auto tile : tileinfo)
 	{
-		return gen->isPossible(tile);
-	});
+		if (gen->isPossible(tile))
+		{
+			possibleTiles.insert(tile);
+			farthestTiles.push(std::make_pair(tile, gen->getNearestObjectDistance(tile)));
+		}
+	}
 	if (freePaths.empty())
 	{
 		gen->setOccupied(pos, ETileType::FREE);
@@ -250,21 +278,19 @@ void CRmgTemplateZone::fractalize()
 		if (gen->isFree(tile))
 			freePaths.insert(tile);
 	}
-	std::vector<int3> clearedTiles (freePaths.begin(), freePaths.end());
-	std::set<int3> possibleTiles;
-	std::set<int3> tilesToIgnore; //will be erased in this iteration
+	CTileSet clearedTiles(freePaths);
+	CTileSet possibleTiles(gen->getMapSize());
+	CTileSet tilesToIgnore(gen->getMapSize()); //will be erased in this iteration
 
 	//the more treasure density, the greater distance between paths. Scaling is experimental.
 	int totalDensity = 0;
 	for (auto ti : treasureInfo)
 		totalDensity += ti.density;
-	const float minDistance = 10 * 10; //squared
+	const ui32 minDistance = 10 * 10; //squared
 
 	for (auto tile : tileinfo)
 	{
-		if (gen->isFree(tile))
-			clearedTiles.push_back(tile);
-		else if (gen->isPossible(tile))
+		if (gen->isPossible(tile))
 			possibleTiles.insert(tile);
 	}
 	assert (clearedTiles.size()); //this should come from zone connections
@@ -279,47 +305,28 @@ void CRmgTemplateZone::fractalize()
 		{
 			//link tiles in random order
 			std::vector<int3> tilesToMakePath(possibleTiles.begin(), possibleTiles.end());
-			RandomGeneratorUtil::randomShuffle(tilesToMakePath, gen->rand);
+			RandomGeneratorUtil::randomShuffle(tilesToMakePath, rand);
 
 			int3 nodeFound(-1, -1, -1);
 
 			for (auto tileToMakePath : tilesToMakePath)
 			{
-				//find closest free tile
-				float currentDistance = 1e10;
-				int3 closestTile(-1, -1, -1);
-
-				for (auto clearTile : clearedTiles)
+				if (clearedTiles.hasTileWithin(tileToMakePath, minDistance))
 				{
-					float distance = static_cast<float>(tileToMakePath.dist2dSQ(clearTile));
-
-					if (distance < currentDistance)
-					{
-						currentDistance = distance;
-						closestTile = clearTile;
-					}
-					if (currentDistance <= minDistance)
-					{
-						//this tile is close enough. Forget about it and check next one
-						tilesToIgnore.insert(tileToMakePath);
-						break;
-					}
+					//this tile is close enough. Forget about it and check next one
+					tilesToIgnore.insert(tileToMakePath);
 				}
-				//if tiles is not close enough, make path to it
-				if (currentDistance > minDistance)
+				else //if tiles is not close enough, make path to it
 				{
 					nodeFound = tileToMakePath;
 					nodes.push_back(nodeFound);
-					clearedTiles.push_back(nodeFound); //from now on nearby tiles will be considered handled
+					clearedTiles.insert(nodeFound); //from now on nearby tiles will be considered handled
 					break; //next iteration - use already cleared tiles
 				}
 			}
 
-			for (auto tileToClear : tilesToIgnore)
-			{
-				//these tiles are already connected, ignore them
-				vstd::erase_if_present(possibleTiles, tileToClear);
-			}
+			//these tiles are already connected, ignore them
+			possibleTiles -= tilesToIgnore;
 			if (!nodeFound.valid()) //nothing else can be done (?)
 				break;
 			tilesToIgnore.clear();
@@ -346,7 +353,7 @@ void CRmgTemplateZone::fractalize()
 		}
 
 		//connect with all the paths
-		crunchPath(node, findClosestTile(freePaths, node), true, &freePaths);
+		crunchPath(node, freePaths.findClosest(node), true, &freePaths);
 		//connect with nearby nodes
 		for (auto nearbyNode : nearbyNodes)
 		{
@@ -358,26 +365,14 @@ void CRmgTemplateZone::fractalize()
 
 	//now block most distant tiles away from passages
 
-	float blockDistance = minDistance * 0.25f;
+	const ui32 blockDistance = minDistance / 4;
 
 	for (auto tile : tileinfo)
 	{
 		if (!gen->isPossible(tile))
 			continue;
 
-		bool closeTileFound = false;
-
-		for (auto clearTile : freePaths)
-		{
-			float distance = static_cast<float>(tile.dist2dSQ(clearTile));
-
-			if (distance < blockDistance)
-			{
-				closeTileFound = true;
-				break;
-			}
-		}
-		if (!closeTileFound) //this tile is far enough from passages
+		if (!freePaths.hasTileWithin(tile, blockDistance - 1)) //this tile is far enough from passages
 			gen->setOccupied(tile, ETileType::BLOCKED);
 	}
 
@@ -426,7 +421,7 @@ void CRmgTemplateZone::connectLater()
 	}
 }
 
-bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles)
+bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet * clearedTiles)
 {
 /*
 make shortest path with free tiles, reachning dst or closest already free tile. Avoid blocks.
@@ -459,9 +454,10 @@ do not leave zone border
 				}
 				if (pos.dist2dSQ (dst) < distance)
 				{
-					if (!gen->isBlocked(pos))
+					//check zone first - tiles of other zones may be modified concurrently
+					if (gen->getZoneID(pos) == id)
 					{
-						if (gen->getZoneID(pos) == id)
+						if (!gen->isBlocked(pos))
 						{
 							if (gen->isPossible(pos))
 							{
@@ -543,7 +539,7 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto pq = createPriorityQueue();    // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -586,7 +582,7 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 
 			auto foo = [this, &pq, &distances, &closed, &cameFrom, &currentNode, &currentTile, &node, &dst, &directNeighbourFound, &movementCost](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos)) //we already visited that node
+				if (closed.contains(pos)) //we already visited that node
 					return;
 				float distance = node.second + movementCost;
 				float bestDistanceSoFar = std::numeric_limits<float>::max();
@@ -633,7 +629,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto open = createPriorityQueue();    // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -669,7 +665,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 		{
 			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (closed.contains(pos))
 					return;
 
 				//no paths through blocked or occupied tiles, stay within zone
@@ -700,7 +696,7 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 	for (auto tile : closed) //these tiles are sealed off and can't be connected anymore
 	{
 		gen->setOccupied (tile, ETileType::BLOCKED);
-		vstd::erase_if_present(possibleTiles, tile);
+		possibleTiles.erase(tile);
 	}
 	return false;
 }
@@ -710,7 +706,7 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	CTileSet closed(gen->getMapSize());    // The set of nodes already evaluated.
 	auto open = createPriorityQueue(); // The set of tentative nodes to be evaluated, initially containing the start node
 	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
 	std::map<int3, float> distances;
@@ -743,7 +739,7 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 		{
 			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (closed.contains(pos))
 					return;
 
 				if (gen->getZoneID(pos) != id)
@@ -833,10 +829,10 @@ bool CRmgTemplateZone::addMonster(int3 &pos, si32 strength, bool clearSurroundin
 	}
 	if (possibleCreatures.size())
 	{
-		creId = *RandomGeneratorUtil::nextItem(possibleCreatures, gen->rand);
+		creId = *RandomGeneratorUtil::nextItem(possibleCreatures, rand);
 		amount = strength / VLC->creh->creatures[creId]->AIValue;
 		if (amount >= 4)
-			amount = static_cast<int>(amount * gen->rand.nextDouble(0.75, 1.25));
+			amount = static_cast<int>(amount * rand.nextDouble(0.75, 1.25));
 	}
 	else //just pick any available creature
 	{
@@ -869,17 +865,17 @@ bool CRmgTemplateZone::addMonster(int3 &pos, si32 strength, bool clearSurroundin
 
 bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CTreasureInfo& treasureInfo)
 {
-	CTreasurePileInfo info;
+	CTreasurePileInfo info(gen->getMapSize());
 
 	std::map<int3, CGObjectInstance *> treasures;
-	std::set<int3> boundary;
+	CTileSet boundary(gen->getMapSize());
 	int3 guardPos (-1,-1,-1);
 	info.nextTreasurePos = pos;
 
 	int maxValue = treasureInfo.max;
 	int minValue = treasureInfo.min;
 
-	ui32 desiredValue = (gen->rand.nextInt(minValue, maxValue));
+	ui32 desiredValue = (rand.nextInt(minValue, maxValue));
 
 	int currentValue = 0;
 	CGObjectInstance * object = nullptr;
@@ -897,7 +893,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 		for (auto treasurePos : treasures)
 		{
 			//leaving only boundary around objects
-			vstd::erase_if_present(boundary, treasurePos.first);
+			boundary.erase(treasurePos.first);
 		}
 
 		for (auto tile : boundary)
@@ -949,7 +945,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 
 			//randomize next position from among possible ones
 			std::vector<int3> boundaryCopy (boundary.begin(), boundary.end());
-			//RandomGeneratorUtil::randomShuffle(boundaryCopy, gen->rand);
+			//RandomGeneratorUtil::randomShuffle(boundaryCopy, rand);
 			auto chooseTopTile = [](const int3 & lhs, const int3 & rhs) -> bool
 			{
 				return lhs.y < rhs.y;
@@ -989,7 +985,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 
 		for (auto visitablePos : info.visitableFromBottomPositions) //objects that are not visitable from top must be accessible from bottom or side
 		{
-			int3 closestFreeTile = findClosestTile(freePaths, visitablePos);
+			int3 closestFreeTile = freePaths.findClosest(visitablePos);
 			if (closestFreeTile.dist2d(visitablePos) < minTreasureDistance)
 			{
 				closestTile = visitablePos + int3 (0, 1, 0); //start below object (y+1), possibly even outside the map, to not make path up through it
@@ -998,7 +994,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 		}
 		for (auto visitablePos : info.visitableFromTopPositions) //all objects are accessible from any direction
 		{
-			int3 closestFreeTile = findClosestTile(freePaths, visitablePos);
+			int3 closestFreeTile = freePaths.findClosest(visitablePos);
 			if (closestFreeTile.dist2d(visitablePos) < minTreasureDistance)
 			{
 				closestTile = visitablePos;
@@ -1094,7 +1090,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 	else //we did not place eveyrthing successfully
 	{
 		gen->setOccupied(pos, ETileType::BLOCKED); //TODO: refactor stop condition
-		vstd::erase_if_present(possibleTiles, pos);
+		possibleTiles.erase(pos);
 		return false;
 	}
 }
@@ -1127,9 +1123,9 @@ void CRmgTemplateZone::initTownType ()
 				if(!this->townsAreSameType)
 				{
 					if (townTypes.size())
-						subType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+						subType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 					else
-						subType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), gen->rand); //it is possible to have zone with no towns allowed
+						subType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), rand); //it is possible to have zone with no towns allowed
 				}
 			}
 
@@ -1238,16 +1234,16 @@ void CRmgTemplateZone::initTownType ()
 	if (!totalTowns) //if there's no town present, get random faction for dwellings and pandoras
 	{
 		//25% chance for neutral
-		if (gen->rand.nextInt(1, 100) <= 25)
+		if (rand.nextInt(1, 100) <= 25)
 		{
 			townType = ETownType::NEUTRAL;
 		}
 		else
 		{
 			if (townTypes.size())
-				townType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+				townType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 			else if (monsterTypes.size())
-				townType = *RandomGeneratorUtil::nextItem(monsterTypes, gen->rand); //this happens in Clash of Dragons in treasure zones, where all towns are banned
+				townType = *RandomGeneratorUtil::nextItem(monsterTypes, rand); //this happens in Clash of Dragons in treasure zones, where all towns are banned
 			else //just in any case
 				randomizeTownType();
 		}
@@ -1257,9 +1253,9 @@ void CRmgTemplateZone::initTownType ()
 void CRmgTemplateZone::randomizeTownType ()
 {
 	if (townTypes.size())
-		townType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+		townType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 	else
-		townType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), gen->rand); //it is possible to have zone with no towns allowed, we still need some
+		townType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), rand); //it is possible to have zone with no towns allowed, we still need some
 }
 
 void CRmgTemplateZone::initTerrainType ()
@@ -1268,7 +1264,7 @@ void CRmgTemplateZone::initTerrainType ()
 	if (matchTerrainToTown && townType != ETownType::NEUTRAL)
 		terrainType = VLC->townh->factions[townType]->nativeTerrain;
 	else
-		terrainType = *RandomGeneratorUtil::nextItem(terrainTypes, gen->rand);
+		terrainType = *RandomGeneratorUtil::nextItem(terrainTypes, rand);
 
 	//TODO: allow new types of terrain?
 	if (pos.z)
@@ -1289,7 +1285,7 @@ void CRmgTemplateZone::paintZoneTerrain (ETerrainType terrainType)
 {
 	std::vector<int3> tiles(tileinfo.begin(), tileinfo.end());
 	gen->editManager->getTerrainSelection().setSelection(tiles);
-	gen->editManager->drawTerrain(terrainType, &gen->rand);
+	gen->editManager->drawTerrain(terrainType, &rand);
 }
 
 bool CRmgTemplateZone::placeMines ()
@@ -1505,10 +1501,11 @@ void CRmgTemplateZone::createTreasures()
 		bool stop = false;
 		do {
 			//optimization - don't check tiles which are not allowed
-			vstd::erase_if(possibleTiles, [this](const int3 &tile) -> bool
+			for (auto tile : possibleTiles)
 			{
-				return !gen->isPossible(tile);
-			});
+				if (!gen->isPossible(tile))
+					possibleTiles.erase(tile);
+			}
 
 
 			int3 treasureTilePos;
@@ -1542,7 +1539,7 @@ void CRmgTemplateZone::createObstacles1()
 			}
 		}
 		gen->editManager->getTerrainSelection().setSelection(accessibleTiles);
-		gen->editManager->drawTerrain(terrainType, &gen->rand);
+		gen->editManager->drawTerrain(terrainType, &rand);
 	}
 }
 
@@ -1586,7 +1583,7 @@ void CRmgTemplateZone::createObstacles2()
 
 	auto tryToPlaceObstacleHere = [this, &possibleObstacles](int3& tile, int index)-> bool
 	{
-		auto temp = *RandomGeneratorUtil::nextItem(possibleObstacles[index].second, gen->rand);
+		auto temp = *RandomGeneratorUtil::nextItem(possibleObstacles[index].second, rand);
 		int3 obstaclePos = tile + temp.getBlockMapOffset();
 		if (canObstacleBePlacedHere(temp, obstaclePos)) //can be placed here
 		{
@@ -1601,7 +1598,7 @@ void CRmgTemplateZone::createObstacles2()
 	for (auto tile : boost::adaptors::reverse(tileinfo))
 	{
 		//fill tiles that should be blocked with obstacles or are just possible (with some probability)
-		if (gen->shouldBeBlocked(tile) || (gen->isPossible(tile) && gen->rand.nextInt(1,100) < 60))
+		if (gen->shouldBeBlocked(tile) || (gen->isPossible(tile) && rand.nextInt(1,100) < 60))
 		{
 			//start from biggets obstacles
 			for (int i = 0; i < possibleObstacles.size(); i++)
@@ -1625,8 +1622,8 @@ void CRmgTemplateZone::connectRoads()
 {
 	logGlobal->debug("Started building roads");
 
-	std::set<int3> roadNodesCopy(roadNodes);
-	std::set<int3> processed;
+	CTileSet roadNodesCopy(roadNodes);
+	CTileSet processed(gen->getMapSize());
 
 	while(!roadNodesCopy.empty())
 	{
@@ -1651,7 +1648,7 @@ void CRmgTemplateZone::connectRoads()
 		if (createRoad(node, cross))
 		{
 			processed.insert(cross); //don't draw road starting at end point which is already connected
-			vstd::erase_if_present(roadNodesCopy, cross);
+			roadNodesCopy.erase(cross);
 		}
 
 		processed.insert(node);
@@ -1677,22 +1674,26 @@ void CRmgTemplateZone::drawRoads()
 	}
 
 	gen->editManager->getTerrainSelection().setSelection(tiles);
-	gen->editManager->drawRoad(ERoadType::COBBLESTONE_ROAD, &gen->rand);
+	gen->editManager->drawRoad(ERoadType::COBBLESTONE_ROAD, &rand);
 }
 
 
-bool CRmgTemplateZone::fill()
+void CRmgTemplateZone::createPaths()
 {
-	initTerrainType();
-
 	//zone center should be always clear to allow other tiles to connect
 	gen->setOccupied(pos, ETileType::FREE);
 	freePaths.insert(pos);
 
-	addAllPossibleObjects ();
-
 	connectLater(); //ideally this should work after fractalize, but fails
 	fractalize();
+}
+
+bool CRmgTemplateZone::fill()
+{
+	initTerrainType();
+
+	addAllPossibleObjects ();
+
 	placeMines();
 	createRequiredObjects();
 	createTreasures();
@@ -1703,34 +1704,47 @@ bool CRmgTemplateZone::fill()
 
 bool CRmgTemplateZone::findPlaceForTreasurePile(float min_dist, int3 &pos, int value)
 {
-	float best_distance = 0;
 	bool result = false;
 
 	bool needsGuard = value > minGuardedValue;
 
 	//logGlobal->info("Min dist for density %f is %d", density, min_dist);
-	for(auto tile : possibleTiles)
+	//check possible tiles from the farthest one, tiles that don't fit now may fit in later calls
+	std::vector<TDistance> skippedTiles;
+	while (!farthestTiles.empty())
 	{
-		auto dist = gen->getNearestObjectDistance(tile);
+		auto entry = farthestTiles.top();
+		if (isOutdated(entry))
+		{
+			farthestTiles.pop();
+			continue;
+		}
 
-		if ((dist >= min_dist) && (dist > best_distance))
+		float dist = entry.second;
+		if (dist < min_dist || dist <= 0)
+			break;
+
+		farthestTiles.pop();
+		skippedTiles.push_back(entry);
+
+		bool allTilesAvailable = true;
+		gen->foreach_neighbour (entry.first, [this, &allTilesAvailable, needsGuard](int3 neighbour)
 		{
-			bool allTilesAvailable = true;
-			gen->foreach_neighbour (tile, [this, &allTilesAvailable, needsGuard](int3 neighbour)
-			{
-				if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
-				{
-					allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
-				}
-			});
-			if (allTilesAvailable)
+			if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
 			{
-				best_distance = dist;
-				pos = tile;
-				result = true;
+				allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
 			}
+		});
+		if (allTilesAvailable)
+		{
+			pos = entry.first;
+			result = true;
+			break;
 		}
 	}
+	for (auto & entry : skippedTiles)
+		farthestTiles.push(entry);
+
 	if (result)
 	{
 		gen->setOccupied(pos, ETileType::BLOCKED); //block that tile //FIXME: why?
@@ -1913,13 +1927,39 @@ void CRmgTemplateZone::placeObject(CGObjectInstance* object, const int3 &pos, bo
 	}
 }
 
+bool CRmgTemplateZone::isOutdated(const TDistance & entry) const
+{
+	return !possibleTiles.contains(entry.first) || gen->getNearestObjectDistance(entry.first) != entry.second;
+}
+
+void CRmgTemplateZone::removeOutdatedDistances()
+{
+	while (!farthestTiles.empty() && isOutdated(farthestTiles.top()))
+		farthestTiles.pop();
+}
+
 void CRmgTemplateZone::updateDistances(const int3 & pos)
 {
-	for (auto tile : possibleTiles) //don't need to mark distance for not possible tiles
+	removeOutdatedDistances();
+	if (farthestTiles.empty())
+		return;
+
+	//tiles farther from new object than the farthest possible tile from any object won't change
+	const int3 mapSize = gen->getMapSize();
+	const float maxDistance = farthestTiles.top().second;
+	const ui32 mapDiagonal = static_cast<ui32>(mapSize.x * mapSize.x + mapSize.y * mapSize.y);
+	const ui32 window = maxDistance < mapDiagonal ? static_cast<ui32>(maxDistance) : mapDiagonal;
+
+	possibleTiles.foreachTileWithin(pos, window, [this, &pos](const int3 & tile)  //don't need to mark distance for not possible tiles
 	{
-		ui32 d = pos.dist2dSQ(tile); //optimization, only relative distance is interesting
-		gen->setNearestObjectDistance(tile, std::min((float)d, gen->getNearestObjectDistance(tile)));
-	}
+		float d = static_cast<float>(pos.dist2dSQ(tile)); //optimization, only relative distance is interesting
+		if (d < gen->getNearestObjectDistance(tile))
+		{
+			int3 target = tile;
+			gen->setNearestObjectDistance(target, d);
+			farthestTiles.push(std::make_pair(tile, d));
+		}
+	});
 }
 
 void CRmgTemplateZone::placeAndGuardObject(CGObjectInstance* object, const int3 &pos, si32 str, bool zoneGuard)
@@ -2096,7 +2136,7 @@ ObjectInfo CRmgTemplateZone::getRandomObject(CTreasurePileInfo &info, ui32 desir
 			for (auto blockingTile : blockedOffsets)
 			{
 				int3 t = info.nextTreasurePos + newVisitableOffset + blockingTile;
-				if (!gen->map->isInTheMap(t) || vstd::contains(info.occupiedPositions, t))
+				if (!gen->map->isInTheMap(t) || info.occupiedPositions.contains(t))
 				{
 					fitsBlockmap = false; //if at least one tile is not possible, object can't be placed here
 					break;
@@ -2147,7 +2187,7 @@ ObjectInfo CRmgTemplateZone::getRandomObject(CTreasurePileInfo &info, ui32 desir
 	}
 	else
 	{
-		int r = gen->rand.nextInt (1, total);
+		int r = rand.nextInt (1, total);
 
 		//binary search = fastest
 		auto it = std::lower_bound(thresholds.begin(), thresholds.end(), r,
@@ -2218,7 +2258,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					possibleHeroes.push_back(j);
 			}
 
-			auto hid = *RandomGeneratorUtil::nextItem(possibleHeroes, gen->rand);
+			auto hid = *RandomGeneratorUtil::nextItem(possibleHeroes, rand);
 			auto factory = VLC->objtypeh->getHandlerFor(Obj::PRISON, 0);
 			auto obj = (CGHeroInstance *) factory->create(ObjectTemplate());
 
@@ -2300,7 +2340,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					out.push_back(spell->id);
 				}
 			}
-			auto a = CArtifactInstance::createScroll(RandomGeneratorUtil::nextItem(out, gen->rand)->toSpell());
+			auto a = CArtifactInstance::createScroll(RandomGeneratorUtil::nextItem(out, rand)->toSpell());
 			obj->storedArtifact = a;
 			return obj;
 		};
@@ -2408,7 +2448,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					spells.push_back(spell);
 			}
 
-			RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+			RandomGeneratorUtil::randomShuffle(spells, rand);
 			for (int j = 0; j < std::min(12, (int)spells.size()); j++)
 			{
 				obj->spells.push_back(spells[j]->id);
@@ -2438,7 +2478,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					spells.push_back(spell);
 			}
 
-			RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+			RandomGeneratorUtil::randomShuffle(spells, rand);
 			for (int j = 0; j < std::min(15, (int)spells.size()); j++)
 			{
 				obj->spells.push_back(spells[j]->id);
@@ -2466,7 +2506,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				spells.push_back(spell);
 		}
 
-		RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+		RandomGeneratorUtil::randomShuffle(spells, rand);
 		for (int j = 0; j < std::min(60, (int)spells.size()); j++)
 		{
 			obj->spells.push_back(spells[j]->id);
@@ -2499,7 +2539,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 		}
 		oi.maxPerZone = seerHutsPerType;
 
-		RandomGeneratorUtil::randomShuffle(creatures, gen->rand);
+		RandomGeneratorUtil::randomShuffle(creatures, rand);
 
 		auto generateArtInfo = [this](ArtifactID id) -> ObjectInfo
 		{
@@ -2524,7 +2564,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 			if (!creaturesAmount)
 				continue;
 
-			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), gen->rand);
+			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), rand);
 
 			oi.generateObject = [creature, creaturesAmount, randomAppearance, this, generateArtInfo]() -> CGObjectInstance *
 			{
@@ -2535,7 +2575,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = creaturesAmount;
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
@@ -2557,7 +2597,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 
 		for (int i = 0; i < 4; i++) //seems that code for exp and gold reward is similiar
 		{
-			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), gen->rand);
+			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), rand);
 
 			oi.setTemplate(Obj::SEER_HUT, randomAppearance, terrainType);
 			oi.value = seerValues[i];
@@ -2573,7 +2613,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = seerExpGold[i];
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
@@ -2596,7 +2636,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = seerExpGold[i];
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
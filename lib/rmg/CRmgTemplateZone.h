@@ -14,6 +14,7 @@
 #include "CMapGenerator.h"
 #include "float3.h"
 #include "../int3.h"
+#include "../mapping/CTileSet.h"
 #include "CRmgTemplate.h"
 #include "../mapObjects/ObjectTemplate.h"
 #include <boost/heap/priority_queue.hpp> //A*
@@ -78,11 +79,13 @@ struct DLL_LINKAGE ObjectInfo
 
 struct DLL_LINKAGE CTreasurePileInfo
 {
-	std::set<int3> visitableFromBottomPositions; //can be visited only from bottom or side
-	std::set<int3> visitableFromTopPositions; //they can be visited from any direction
-	std::set<int3> blockedPositions;
-	std::set<int3> occupiedPositions; //blocked + visitable
+	CTileSet visitableFromBottomPositions; //can be visited only from bottom or side
+	CTileSet visitableFromTopPositions; //they can be visited from any direction
+	CTileSet blockedPositions;
+	CTileSet occupiedPositions; //blocked + visitable
 	int3 nextTreasurePos;
+
+	explicit CTreasurePileInfo(const int3 & mapSize);
 };
 
 /// The CRmgTemplateZone describes a zone in a template.
@@ -94,9 +97,13 @@ public:
 	void setOptions(const rmg::ZoneOptions * options);
 
 	void setGenPtr(CMapGenerator * Gen);
+	/// every zone uses its own random generator, so result does not depend on order in which zones are processed
+	void setRandomSeed(int seed);
 
 	float3 getCenter() const;
 	void setCenter(const float3 &f);
+	/// position limited to (0,1) square same way as setCenter does
+	static float3 wrapCenter(const float3 &f);
 	int3 getPos() const;
 	void setPos(const int3 &pos);
 	bool isAccessibleFromAnywhere(ObjectTemplate &appearance, int3 &tile) const;
@@ -104,8 +111,8 @@ public:
 
 	void addTile (const int3 &pos);
 	void initFreeTiles ();
-	std::set<int3> getTileInfo() const;
-	std::set<int3> getPossibleTiles() const;
+	const CTileSet & getTileInfo() const;
+	const CTileSet & getPossibleTiles() const;
 	void discardDistantTiles (float distance);
 	void clearTiles();
 
@@ -121,6 +128,9 @@ public:
 	void randomizeTownType(); //helper function
 	void initTerrainType ();
 	void createBorder();
+	/// clears center of the zone and creates paths through it. Modifies only tiles of this zone,
+	/// so it can run concurrently for all zones
+	void createPaths();
 	void fractalize();
 	void connectLater();
 	EObjectPlacingResult::EObjectPlacingResult tryToPlaceObjectAndConnectToPath(CGObjectInstance *obj, int3 &pos); //return true if the position cna be connected
@@ -128,7 +138,7 @@ public:
 	void createTreasures();
 	void createObstacles1();
 	void createObstacles2();
-	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles = nullptr);
+	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet * clearedTiles = nullptr);
 	bool connectPath(const int3& src, bool onlyStraight);
 	bool connectWithCenter(const int3& src, bool onlyStraight);
 	void updateDistances(const int3 & pos);
@@ -137,7 +147,7 @@ public:
 	bool areAllTilesAvailable(CGObjectInstance* obj, int3& tile, std::set<int3>& tilesBlockedByObject) const;
 
 	void setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZone);
-	std::set<int3>* getFreePaths();
+	CTileSet * getFreePaths();
 
 	ObjectInfo getRandomObject (CTreasurePileInfo &info, ui32 desiredValue, ui32 maxValue, ui32 currentValue);
 
@@ -159,8 +169,18 @@ public:
 	};
 	boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>> createPriorityQueue();
 
+	//possible tiles farthest from objects first, tiles with same distance in same order as in tile sets
+	struct FarthestTileComparer
+	{
+		bool operator()(const TDistance & lhs, const TDistance & rhs) const
+		{
+			return lhs.second < rhs.second || (lhs.second == rhs.second && rhs.first < lhs.first);
+		}
+	};
+
 private:
 	CMapGenerator * gen;
+	CRandomGenerator rand;
 	//template info
 
 	si32 townType;
@@ -178,13 +198,19 @@ private:
 	//placement info
 	int3 pos;
 	float3 center;
-	std::set<int3> tileinfo; //irregular area assined to zone
-	std::set<int3> possibleTiles; //optimization purposes for treasure generation
-	std::set<int3> freePaths; //core paths of free tiles that all other objects will be linked to
-
-	std::set<int3> roadNodes; //tiles to be connected with roads
-	std::set<int3> roads; //all tiles with roads
-	std::set<int3> tilesToConnectLater; //will be connected after paths are fractalized
+	CTileSet tileinfo; //irregular area assined to zone
+	CTileSet possibleTiles; //optimization purposes for treasure generation
+	CTileSet freePaths; //core paths of free tiles that all other objects will be linked to
+
+	CTileSet roadNodes; //tiles to be connected with roads
+	CTileSet roads; //all tiles with roads
+	CTileSet tilesToConnectLater; //will be connected after paths are fractalized
+
+	//distances of possible tiles to nearest object. Entries of tiles that are no longer possible
+	//or got closer to new object are outdated and skipped when they get to the top
+	boost::heap::priority_queue<TDistance, boost::heap::compare<FarthestTileComparer>> farthestTiles;
+	bool isOutdated(const TDistance & entry) const;
+	void removeOutdatedDistances();
 
 	bool createRoad(const int3 &src, const int3 &dst);
 	void drawRoads(); //actually updates tiles
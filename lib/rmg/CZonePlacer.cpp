@@ -15,6 +15,7 @@
 #include "../mapping/CMap.h"
 
 #include "CZoneGraphGenerator.h"
+#include "../CThreadHelper.h"
 
 class CRandomGenerator;
 
@@ -40,7 +41,7 @@ float CZonePlacer::getDistance (float distance) const
 	return (distance ? distance * distance : 1e-6f);
 }
 
-void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand)
+void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand, int attempts)
 {
 	logGlobal->info("Starting zone placement");
 
@@ -67,96 +68,164 @@ void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenera
 	//0. set zone sizes and surface / underground level
 	prepareZones(zones, zonesVector, underground, rand);
 
-	//gravity-based algorithm. connected zones attract, intersecting zones and map boundaries push back
+	//copy zone data to arrays, so attempts don't need to touch zone objects
+	std::map<TRmgTemplateZoneId, size_t> indexes;
+	placedZones.clear();
+	zoneSizes.clear();
+	zoneConnections.clear();
+	for (auto zone : zones)
+	{
+		indexes[zone.first] = placedZones.size();
+		placedZones.push_back(zone.second);
+		zoneSizes.push_back(zone.second->getSize());
+	}
+
+	std::vector<float3> startingCenters;
+	for (auto zone : placedZones)
+	{
+		std::vector<size_t> connections;
+		for (auto con : zone->getConnections())
+			connections.push_back(indexes.at(con));
+		zoneConnections.push_back(connections);
+		startingCenters.push_back(zone->getCenter());
+	}
+
+	//first attempt starts from prepared positions, other ones from random positions on same levels
+	std::vector<Layout> layouts(1, Layout(startingCenters));
+	for (int i = 1; i < attempts; i++)
+	{
+		CRandomGenerator attemptRand;
+		attemptRand.setSeed(rand->nextInt());
+		std::vector<float3> centers;
+		for (auto center : startingCenters)
+			centers.push_back(getRandomCenter(center.z, &attemptRand));
+		layouts.push_back(Layout(centers));
+	}
+
+	std::vector<Task> tasks;
+	for (auto & layout : layouts)
+	{
+		tasks.push_back([this, &layout]()
+		{
+			improveLayout(layout);
+		});
+	}
+	gen->runTasks(tasks);
+
+	//ties are resolved in favor of earlier attempt, so result doesn't depend on number of threads
+	const Layout * best = &layouts.front();
+	for (auto & layout : layouts)
+	{
+		if (best->isImprovement(layout.bestTotalDistance, layout.bestTotalOverlap))
+			best = &layout;
+	}
+
+	logGlobal->trace("Best fitness reached: total distance %2.4f, total overlap %2.4f", best->bestTotalDistance, best->bestTotalOverlap);
+	for (size_t i = 0; i < placedZones.size(); i++) //finalize zone positions
+	{
+		auto zone = placedZones[i];
+		zone->setCenter (best->bestCenters[i]);
+		zone->setPos (cords (best->bestCenters[i]));
+		logGlobal->trace("Placed zone %d at relative position %s and coordinates %s", zone->getId(), zone->getCenter().toString(), zone->getPos().toString());
+	}
+}
+
+CZonePlacer::Layout::Layout(const std::vector<float3> & centers)
+	: centers(centers), forces(centers.size()), totalForces(centers.size()), distances(centers.size(), 0), overlaps(centers.size(), 0),
+	bestCenters(centers), bestTotalDistance(1e10), bestTotalOverlap(1e10)
+{
 
-	//remember best solution
-	float bestTotalDistance = 1e10;
-	float bestTotalOverlap = 1e10;
+}
 
-	std::map<std::shared_ptr<CRmgTemplateZone>, float3> bestSolution;
+bool CZonePlacer::Layout::isImprovement(float totalDistance, float totalOverlap) const
+{
+	if (bestTotalDistance > 0 && bestTotalOverlap > 0)
+		return totalDistance * totalOverlap < bestTotalDistance * bestTotalOverlap;
+	else
+		return totalDistance + totalOverlap < bestTotalDistance + bestTotalOverlap;
+}
 
-	TForceVector forces;
-	TForceVector totalForces; //  both attraction and pushback, overcomplicated?
-	TDistanceVector distances;
-	TDistanceVector overlaps;
+float3 CZonePlacer::getRandomCenter(int level, CRandomGenerator * rand) const
+{
+	const float radius = 0.4f;
+	const float pi2 = 6.28f;
+
+	float randomAngle = static_cast<float>(rand->nextDouble(0, pi2));
+	return float3(0.5f + std::sin(randomAngle) * radius, 0.5f + std::cos(randomAngle) * radius, level); //place zones around circle
+}
 
+void CZonePlacer::improveLayout(Layout & layout) const
+{
+	//gravity-based algorithm. connected zones attract, intersecting zones and map boundaries push back
 	const int MAX_ITERATIONS = 100;
-	for (int i = 0; i < MAX_ITERATIONS; ++i) //until zones reach their desired size and fill the map tightly
+	const double MIN_MOVEMENT_SQ = 1e-12; //zones that moved less than that are considered to be at rest
+
+	const size_t count = layout.centers.size();
+	std::vector<float3> previousCenters;
+
+	int i = 0;
+	for (; i < MAX_ITERATIONS; ++i) //until zones reach their desired size and fill the map tightly
 	{
+		previousCenters = layout.centers;
+
 		//1. attract connected zones
-		attractConnectedZones(zones, forces, distances);
-		for (auto zone : forces)
+		attractConnectedZones(layout);
+		for (size_t n = 0; n < count; n++)
 		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] = zone.second; //override
+			layout.centers[n] = CRmgTemplateZone::wrapCenter(layout.centers[n] + layout.forces[n]);
+			layout.totalForces[n] = layout.forces[n]; //override
 		}
 
 		//2. separate overlapping zones
-		separateOverlappingZones(zones, forces, overlaps);
-		for (auto zone : forces)
+		separateOverlappingZones(layout);
+		for (size_t n = 0; n < count; n++)
 		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] += zone.second; //accumulate
+			layout.centers[n] = CRmgTemplateZone::wrapCenter(layout.centers[n] + layout.forces[n]);
+			layout.totalForces[n] += layout.forces[n]; //accumulate
 		}
 
 		//3. now perform drastic movement of zone that is completely not linked
 
-		moveOneZone(zones, totalForces, distances, overlaps);
+		moveOneZone(layout);
 
 		//4. NOW after everything was moved, re-evaluate zone positions
-		attractConnectedZones(zones, forces, distances);
-		separateOverlappingZones(zones, forces, overlaps);
+		attractConnectedZones(layout);
+		separateOverlappingZones(layout);
 
 		float totalDistance = 0;
 		float totalOverlap = 0;
-		for (auto zone : distances) //find most misplaced zone
+		double maxMovement = 0;
+		for (size_t n = 0; n < count; n++)
 		{
-			totalDistance += zone.second;
-			float overlap = overlaps[zone.first];
-			totalOverlap += overlap;
+			totalDistance += layout.distances[n];
+			totalOverlap += layout.overlaps[n];
+			maxMovement = std::max(maxMovement, layout.centers[n].dist2dSQ(previousCenters[n]));
 		}
 
 		//check fitness function
-		bool improvement = false;
-		if (bestTotalDistance > 0 && bestTotalOverlap > 0)
-		{
-			if (totalDistance * totalOverlap < bestTotalDistance * bestTotalOverlap) //multiplication is better for auto-scaling, but stops working if one factor is 0
-				improvement = true;
-		}
-		else
-		{
-			if (totalDistance + totalOverlap < bestTotalDistance + bestTotalOverlap)
-				improvement = true;
-		}
+		bool improvement = layout.isImprovement(totalDistance, totalOverlap);
 
 		logGlobal->trace("Total distance between zones after this iteration: %2.4f, Total overlap: %2.4f, Improved: %s", totalDistance, totalOverlap , improvement);
 
 		//save best solution
 		if (improvement)
 		{
-			bestTotalDistance = totalDistance;
-			bestTotalOverlap = totalOverlap;
-
-			for (auto zone : zones)
-				bestSolution[zone.second] = zone.second->getCenter();
+			layout.bestTotalDistance = totalDistance;
+			layout.bestTotalOverlap = totalOverlap;
+			layout.bestCenters = layout.centers;
 		}
-	}
 
-	logGlobal->trace("Best fitness reached: total distance %2.4f, total overlap %2.4f", bestTotalDistance, bestTotalOverlap);
-	for (auto zone : zones) //finalize zone positions
-	{
-		zone.second->setPos (cords (bestSolution[zone.second]));
-		logGlobal->trace("Placed zone %d at relative position %s and coordinates %s", zone.first, zone.second->getCenter().toString(), zone.second->getPos().toString());
+		//same positions give same forces, further iterations can't find anything better
+		if (maxMovement < MIN_MOVEMENT_SQ)
+			break;
 	}
+	logGlobal->trace("Zone placement finished after %d iterations", std::min(i + 1, MAX_ITERATIONS));
 }
 
 void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const bool underground, CRandomGenerator * rand)
 {
 	std::vector<float> totalSize = { 0, 0 }; //make sure that sum of zone sizes on surface and uderground match size of the map
 
-	const float radius = 0.4f;
-	const float pi2 = 6.28f;
-
 	int zonesOnLevel[2] = { 0, 0 };
 
 	//even distribution for surface / underground zones. Surface zones always have priority.
@@ -236,8 +305,7 @@ void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const
 	{
 		int level = levels[zone.first];
 		totalSize[level] += (zone.second->getSize() * zone.second->getSize());
-		float randomAngle = static_cast<float>(rand->nextDouble(0, pi2));
-		zone.second->setCenter(float3(0.5f + std::sin(randomAngle) * radius, 0.5f + std::cos(randomAngle) * radius, level)); //place zones around circle
+		zone.second->setCenter(getRandomCenter(level, rand));
 	}
 
 	/*
@@ -258,25 +326,24 @@ void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const
 	}
 }
 
-void CZonePlacer::attractConnectedZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &distances)
+void CZonePlacer::attractConnectedZones(Layout & layout) const
 {
-	for (auto zone : zones)
+	for (size_t i = 0; i < layout.centers.size(); i++)
 	{
 		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
+		float3 pos = layout.centers[i];
 		float totalDistance = 0;
 
-		for (auto con : zone.second->getConnections())
+		for (auto con : zoneConnections[i])
 		{
-			auto otherZone = zones[con];
-			float3 otherZoneCenter = otherZone->getCenter();
+			float3 otherZoneCenter = layout.centers[con];
 			float distance = static_cast<float>(pos.dist2d(otherZoneCenter));
 			float minDistance = 0;
 
 			if (pos.z != otherZoneCenter.z)
 				minDistance = 0; //zones on different levels can overlap completely
 			else
-				minDistance = (zone.second->getSize() + otherZone->getSize()) / mapSize; //scale down to (0,1) coordinates
+				minDistance = (zoneSizes[i] + zoneSizes[con]) / mapSize; //scale down to (0,1) coordinates
 
 			if (distance > minDistance)
 			{
@@ -286,30 +353,30 @@ void CZonePlacer::attractConnectedZones(TZoneMap &zones, TForceVector &forces, T
 				totalDistance += (distance - minDistance);
 			}
 		}
-		distances[zone.second] = totalDistance;
+		layout.distances[i] = totalDistance;
 		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		layout.forces[i] = forceVector;
 	}
 }
 
-void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps)
+void CZonePlacer::separateOverlappingZones(Layout & layout) const
 {
-	for (auto zone : zones)
+	for (size_t i = 0; i < layout.centers.size(); i++)
 	{
 		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
+		float3 pos = layout.centers[i];
 
 		float overlap = 0;
 		//separate overlapping zones
-		for (auto otherZone : zones)
+		for (size_t other = 0; other < layout.centers.size(); other++)
 		{
-			float3 otherZoneCenter = otherZone.second->getCenter();
+			float3 otherZoneCenter = layout.centers[other];
 			//zones on different levels don't push away
-			if (zone == otherZone || pos.z != otherZoneCenter.z)
+			if (i == other || pos.z != otherZoneCenter.z)
 				continue;
 
 			float distance = static_cast<float>(pos.dist2d(otherZoneCenter));
-			float minDistance = (zone.second->getSize() + otherZone.second->getSize()) / mapSize;
+			float minDistance = (zoneSizes[i] + zoneSizes[other]) / mapSize;
 			if (distance < minDistance)
 			{
 				forceVector -= (((otherZoneCenter - pos)*(minDistance / (distance ? distance : 1e-3f))) / getDistance(distance)) * stiffnessConstant; //negative value
@@ -319,7 +386,7 @@ void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces
 
 		//move zones away from boundaries
 		//do not scale boundary distance - zones tend to get squashed
-		float size = zone.second->getSize() / mapSize;
+		float size = zoneSizes[i] / mapSize;
 
 		auto pushAwayFromBoundary = [&forceVector, pos, size, &overlap, this](float x, float y)
 		{
@@ -344,90 +411,94 @@ void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces
 		{
 			pushAwayFromBoundary(pos.x, 1);
 		}
-		overlaps[zone.second] = overlap;
+		layout.overlaps[i] = overlap;
 		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		layout.forces[i] = forceVector;
 	}
 }
 
-void CZonePlacer::moveOneZone(TZoneMap &zones, TForceVector &totalForces, TDistanceVector &distances, TDistanceVector &overlaps)
+void CZonePlacer::moveOneZone(Layout & layout) const
 {
+	const size_t count = layout.centers.size();
+	const size_t NONE = count;
+
 	float maxRatio = 0;
-	const int maxDistanceMovementRatio = static_cast<int>(zones.size() * zones.size()); //experimental - the more zones, the greater total distance expected
-	std::shared_ptr<CRmgTemplateZone> misplacedZone;
+	const int maxDistanceMovementRatio = static_cast<int>(count * count); //experimental - the more zones, the greater total distance expected
+	size_t misplacedZone = NONE;
 
 	float totalDistance = 0;
 	float totalOverlap = 0;
-	for (auto zone : distances) //find most misplaced zone
+	for (size_t i = 0; i < count; i++) //find most misplaced zone
 	{
-		totalDistance += zone.second;
-		float overlap = overlaps[zone.first];
+		totalDistance += layout.distances[i];
+		float overlap = layout.overlaps[i];
 		totalOverlap += overlap;
-		float ratio = (zone.second + overlap) / (float)totalForces[zone.first].mag(); //if distance to actual movement is long, the zone is misplaced
+		float ratio = (layout.distances[i] + overlap) / (float)layout.totalForces[i].mag(); //if distance to actual movement is long, the zone is misplaced
 		if (ratio > maxRatio)
 		{
 			maxRatio = ratio;
-			misplacedZone = zone.first;
+			misplacedZone = i;
 		}
 	}
 	logGlobal->trace("Worst misplacement/movement ratio: %3.2f", maxRatio);
 
-	if (maxRatio > maxDistanceMovementRatio && misplacedZone)
+	if (maxRatio > maxDistanceMovementRatio && misplacedZone != NONE)
 	{
-		std::shared_ptr<CRmgTemplateZone> targetZone;
-		float3 ourCenter = misplacedZone->getCenter();
+		size_t targetZone = NONE;
+		float3 ourCenter = layout.centers[misplacedZone];
 
 		if (totalDistance > totalOverlap)
 		{
 			//find most distant zone that should be attracted and move inside it
 			float maxDistance = 0;
-			for (auto con : misplacedZone->getConnections())
+			for (auto con : zoneConnections[misplacedZone])
 			{
-				auto otherZone = zones[con];
-				float distance = static_cast<float>(otherZone->getCenter().dist2dSQ(ourCenter));
+				float distance = static_cast<float>(layout.centers[con].dist2dSQ(ourCenter));
 				if (distance > maxDistance)
 				{
 					maxDistance = distance;
-					targetZone = otherZone;
+					targetZone = con;
 				}
 			}
-			if (targetZone) //TODO: consider refactoring duplicated code
+			if (targetZone != NONE) //TODO: consider refactoring duplicated code
 			{
-				float3 vec = targetZone->getCenter() - ourCenter;
-				float newDistanceBetweenZones = (std::max(misplacedZone->getSize(), targetZone->getSize())) / mapSize;
-				logGlobal->trace("Trying to move zone %d %s towards %d %s. Old distance %f", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), maxDistance);
+				float3 targetCenter = layout.centers[targetZone];
+				float3 vec = targetCenter - ourCenter;
+				float newDistanceBetweenZones = (std::max(zoneSizes[misplacedZone], zoneSizes[targetZone])) / mapSize;
+				logGlobal->trace("Trying to move zone %d %s towards %d %s. Old distance %f", placedZones[misplacedZone]->getId(), ourCenter.toString(), placedZones[targetZone]->getId(), targetCenter.toString(), maxDistance);
 				logGlobal->trace("direction is %s", vec.toString());
 
-				misplacedZone->setCenter(targetZone->getCenter() - vec.unitVector() * newDistanceBetweenZones); //zones should now overlap by half size
-				logGlobal->trace("New distance %f", targetZone->getCenter().dist2d(misplacedZone->getCenter()));
+				layout.centers[misplacedZone] = CRmgTemplateZone::wrapCenter(targetCenter - vec.unitVector() * newDistanceBetweenZones); //zones should now overlap by half size
+				logGlobal->trace("New distance %f", targetCenter.dist2d(layout.centers[misplacedZone]));
 			}
 		}
 		else
 		{
 			float maxOverlap = 0;
-			for (auto otherZone : zones)
+			for (size_t other = 0; other < count; other++)
 			{
-				float3 otherZoneCenter = otherZone.second->getCenter();
+				float3 otherZoneCenter = layout.centers[other];
 
-				if (otherZone.second == misplacedZone || otherZoneCenter.z != ourCenter.z)
+				if (other == misplacedZone || otherZoneCenter.z != ourCenter.z)
 					continue;
 
 				float distance = static_cast<float>(otherZoneCenter.dist2dSQ(ourCenter));
 				if (distance > maxOverlap)
 				{
 					maxOverlap = distance;
-					targetZone = otherZone.second;
+					targetZone = other;
 				}
 			}
-			if (targetZone)
+			if (targetZone != NONE)
 			{
-				float3 vec = ourCenter - targetZone->getCenter();
-				float newDistanceBetweenZones = (misplacedZone->getSize() + targetZone->getSize()) / mapSize;
-				logGlobal->trace("Trying to move zone %d %s away from %d %s. Old distance %f", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), maxOverlap);
+				float3 targetCenter = layout.centers[targetZone];
+				float3 vec = ourCenter - targetCenter;
+				float newDistanceBetweenZones = (zoneSizes[misplacedZone] + zoneSizes[targetZone]) / mapSize;
+				logGlobal->trace("Trying to move zone %d %s away from %d %s. Old distance %f", placedZones[misplacedZone]->getId(), ourCenter.toString(), placedZones[targetZone]->getId(), targetCenter.toString(), maxOverlap);
 				logGlobal->trace("direction is %s", vec.toString());
 
-				misplacedZone->setCenter(targetZone->getCenter() + vec.unitVector() * newDistanceBetweenZones); //zones should now be just separated
-				logGlobal->trace("New distance %f", targetZone->getCenter().dist2d(misplacedZone->getCenter()));
+				layout.centers[misplacedZone] = CRmgTemplateZone::wrapCenter(targetCenter + vec.unitVector() * newDistanceBetweenZones); //zones should now be just separated
+				logGlobal->trace("New distance %f", targetCenter.dist2d(layout.centers[misplacedZone]));
 			}
 		}
 	}
@@ -453,6 +524,69 @@ d = 0.01 * dx^3 - 0.1618 * dx^2 + 1 * dx + ...
 	return dx * (1.0f + dx * (0.1f + dx * 0.01f)) + dy * (1.618f + dy * (-0.1618f + dy * 0.01618f));
 }
 
+std::vector<size_t> CZonePlacer::findClosestZones(const std::vector<std::shared_ptr<CRmgTemplateZone>> & zones, bool fineEdges) const
+{
+	const int mapWidth = gen->map->width;
+	const int mapHeight = gen->map->height;
+	const int levels = gen->map->twoLevel ? 2 : 1;
+
+	//plain copy of zone data, threads don't touch zone objects
+	std::vector<int3> positions;
+	std::vector<float> sizes;
+	for (auto zone : zones)
+	{
+		positions.push_back(zone->getPos());
+		sizes.push_back(static_cast<float>(zone->getSize()));
+	}
+
+	std::vector<size_t> result(mapWidth * mapHeight * levels);
+
+	auto assignRows = [&](int firstRow, int lastRow)
+	{
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			const int k = row / mapHeight;
+			const int j = row % mapHeight;
+			for (int i = 0; i < mapWidth; i++)
+			{
+				int3 pos(i, j, k);
+				size_t closest = 0;
+				float closestDistance = 0;
+				for (size_t n = 0; n < positions.size(); n++)
+				{
+					float distance = std::numeric_limits<float>::max();
+					if (positions[n].z == k)
+						distance = fineEdges ? metric(pos, positions[n]) : (float)pos.dist2dSQ(positions[n]);
+					distance /= sizes[n]; //bigger zones have smaller distance
+
+					if (!n || distance < closestDistance) //first of equally distant zones wins
+					{
+						closest = n;
+						closestDistance = distance;
+					}
+				}
+				result[row * mapWidth + i] = closest;
+			}
+		}
+	};
+
+	const int rows = mapHeight * levels;
+	const int threads = std::min(gen->getThreadsCount(), rows);
+	std::vector<Task> tasks;
+	for (int t = 0; t < threads; t++)
+	{
+		const int firstRow = rows * t / threads;
+		const int lastRow = rows * (t + 1) / threads;
+		tasks.push_back([=]()
+		{
+			assignRows(firstRow, lastRow);
+		});
+	}
+	gen->runTasks(tasks);
+
+	return result;
+}
+
 void CZonePlacer::assignZones(const CMapGenOptions * mapGenOptions)
 {
 	logGlobal->info("Starting zone colouring");
@@ -466,22 +600,16 @@ void CZonePlacer::assignZones(const CMapGenOptions * mapGenOptions)
 
 	auto zones = gen->getZones();
 
-	typedef std::pair<std::shared_ptr<CRmgTemplateZone>, float> Dpair;
-	std::vector <Dpair> distances;
-	distances.reserve(zones.size());
+	std::vector<std::shared_ptr<CRmgTemplateZone>> zonesVector;
+	for (auto zone : zones)
+		zonesVector.push_back(zone.second);
 
 	//now place zones correctly and assign tiles to each zone
 
-	auto compareByDistance = [](const Dpair & lhs, const Dpair & rhs) -> bool
-	{
-		//bigger zones have smaller distance
-		return lhs.second / lhs.first->getSize() < rhs.second / rhs.first->getSize();
-	};
-
 	auto moveZoneToCenterOfMass = [](std::shared_ptr<CRmgTemplateZone> zone) -> void
 	{
 		int3 total(0, 0, 0);
-		auto tiles = zone->getTileInfo();
+		const auto & tiles = zone->getTileInfo();
 		for (auto tile : tiles)
 		{
 			total += tile;
@@ -498,23 +626,13 @@ void CZonePlacer::assignZones(const CMapGenOptions * mapGenOptions)
 	2. find current center of mass for each zone. Move zone to that center to balance zones sizes
 	*/
 
-	for (int i = 0; i<width; i++)
+	auto closestZones = findClosestZones(zonesVector, false);
+	for (int k = 0; k < levels; k++)
 	{
-		for (int j = 0; j<height; j++)
+		for (int j = 0; j < height; j++)
 		{
-			for (int k = 0; k < levels; k++)
-			{
-				distances.clear();
-				int3 pos(i, j, k);
-				for (auto zone : zones)
-				{
-					if (zone.second->getPos().z == k)
-						distances.push_back(std::make_pair(zone.second, (float)pos.dist2dSQ(zone.second->getPos())));
-					else
-						distances.push_back(std::make_pair(zone.second, std::numeric_limits<float>::max()));
-				}
-				boost::min_element(distances, compareByDistance)->first->addTile(pos); //closest tile belongs to zone
-			}
+			for (int i = 0; i < width; i++)
+				zonesVector[closestZones[(k * height + j) * width + i]]->addTile(int3(i, j, k)); //closest tile belongs to zone
 		}
 	}
 
@@ -526,22 +644,15 @@ void CZonePlacer::assignZones(const CMapGenOptions * mapGenOptions)
 	for (auto zone : zones)
 		zone.second->clearTiles(); //now populate them again
 
-	for (int i=0; i<width; i++)
+	closestZones = findClosestZones(zonesVector, true);
+	for (int k = 0; k < levels; k++)
 	{
-		for(int j=0; j<height; j++)
+		for (int j = 0; j < height; j++)
 		{
-			for (int k = 0; k < levels; k++)
+			for (int i = 0; i < width; i++)
 			{
-				distances.clear();
 				int3 pos(i, j, k);
-				for (auto zone : zones)
-				{
-					if (zone.second->getPos().z == k)
-						distances.push_back (std::make_pair(zone.second, metric(pos, zone.second->getPos())));
-					else
-						distances.push_back (std::make_pair(zone.second, std::numeric_limits<float>::max()));
-				}
-				auto zone = boost::min_element(distances, compareByDistance)->first; //closest tile belongs to zone
+				auto zone = zonesVector[closestZones[(k * height + j) * width + i]]; //closest tile belongs to zone
 				zone->addTile(pos);
 				gen->setZoneID(pos, zone->getId());
 			}
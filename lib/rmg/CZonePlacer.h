@@ -22,8 +22,6 @@ class CMapGenerator;
 
 typedef std::vector<std::pair<TRmgTemplateZoneId, std::shared_ptr<CRmgTemplateZone>>> TZoneVector;
 typedef std::map <TRmgTemplateZoneId, std::shared_ptr<CRmgTemplateZone>> TZoneMap;
-typedef std::map <std::shared_ptr<CRmgTemplateZone>, float3> TForceVector;
-typedef std::map <std::shared_ptr<CRmgTemplateZone>, float> TDistanceVector;
 
 class CZonePlacer
 {
@@ -35,13 +33,39 @@ public:
 	~CZonePlacer();
 
 	void prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const bool underground, CRandomGenerator * rand);
-	void attractConnectedZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &distances);
-	void separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps);
-	void moveOneZone(TZoneMap &zones, TForceVector &totalForces, TDistanceVector &distances, TDistanceVector &overlaps);
-	void placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand);
+	/// attempts greater than 1 start additional placements from random positions on multiple threads, best placement is used
+	void placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand, int attempts = 1);
 	void assignZones(const CMapGenOptions * mapGenOptions);
 
 private:
+	/// state of one placement attempt, all vectors are indexed same as placedZones
+	struct Layout
+	{
+		std::vector<float3> centers;
+		std::vector<float3> forces;
+		std::vector<float3> totalForces; //both attraction and pushback
+		std::vector<float> distances;
+		std::vector<float> overlaps;
+
+		std::vector<float3> bestCenters;
+		float bestTotalDistance;
+		float bestTotalOverlap;
+
+		explicit Layout(const std::vector<float3> & centers);
+		/// fitness function, true if totals are better than best ones. Multiplication is better for auto-scaling, but stops working if one factor is 0
+		bool isImprovement(float totalDistance, float totalOverlap) const;
+	};
+
+	float3 getRandomCenter(int level, CRandomGenerator * rand) const;
+	/// moves zones of layout until they stop moving or iteration limit is reached, does not touch zone objects
+	void improveLayout(Layout & layout) const;
+	void attractConnectedZones(Layout & layout) const;
+	void separateOverlappingZones(Layout & layout) const;
+	void moveOneZone(Layout & layout) const;
+
+	/// index of closest zone for every tile, ordered by level, row and column. Tiles are split between threads
+	std::vector<size_t> findClosestZones(const std::vector<std::shared_ptr<CRmgTemplateZone>> & zones, bool fineEdges) const;
+
 	int width;
 	int height;
 	//metric coefiicients
@@ -51,6 +75,11 @@ private:
 
 	float gravityConstant;
 	float stiffnessConstant;
+
+	//zones ordered by id, their sizes and indexes of connected zones
+	std::vector<std::shared_ptr<CRmgTemplateZone>> placedZones;
+	std::vector<int> zoneSizes;
+	std::vector<std::vector<size_t>> zoneConnections;
     //float a1, b1, c1, a2, b2, c2;
 	//CMap * map;
 	//std::unique_ptr<CZoneGraph> graph;
@@ -0,0 +1,215 @@
+/*
+ * CPackJournal.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPackJournal.h"
+
+#include "../registerTypes/RegisterTypes.h"
+#include "../CRandomGenerator.h"
+#include "../CGameState.h"
+#include "../NetPacksBase.h"
+
+static const std::string CHECKPOINT_PREFIX = "Checkpoint_";
+
+namespace
+{
+	/// Reads packs from journal buffer
+	class CJournalReader : public IBinaryReader
+	{
+		const std::vector<ui8> & buffer;
+		size_t readPos;
+	public:
+		BinaryDeserializer iser;
+
+		CJournalReader(const std::vector<ui8> & Buffer)
+			: buffer(Buffer), readPos(0), iser(this)
+		{
+			registerTypes(iser);
+		}
+
+		int read(void * data, unsigned size) override
+		{
+			if(buffer.size() < readPos + size)
+				throw std::runtime_error(boost::str(boost::format("Cannot read past the pack journal (accessing index %d, while size is %d)!") % (readPos + size - 1) % buffer.size()));
+
+			std::memcpy(data, buffer.data() + readPos, size);
+			readPos += size;
+			return size;
+		}
+	};
+}
+
+SaveCheckpoint::SaveCheckpoint()
+	: token(0)
+{
+}
+
+bool SaveCheckpoint::empty() const
+{
+	return name.empty();
+}
+
+CSaveCheckpoints::CSaveCheckpoints()
+	: deltaSavesCount(0)
+{
+}
+
+const SaveCheckpoint & CSaveCheckpoints::getCurrent() const
+{
+	return current;
+}
+
+bool CSaveCheckpoints::canSaveDelta(const boost::filesystem::path & directory, const std::string & extension, ui32 maxDeltaSaves) const
+{
+	return !current.empty()
+		&& deltaSavesCount < maxDeltaSaves
+		&& boost::filesystem::exists(getPath(directory, current, extension));
+}
+
+const SaveCheckpoint & CSaveCheckpoints::startCheckpoint()
+{
+	current.token = CRandomGenerator::getDefault().getInt64Range(1, std::numeric_limits<int64_t>::max())();
+	current.name = CHECKPOINT_PREFIX + boost::str(boost::format("%016x") % current.token);
+	deltaSavesCount = 0;
+	return current;
+}
+
+void CSaveCheckpoints::deltaSaved()
+{
+	deltaSavesCount++;
+}
+
+void CSaveCheckpoints::clear()
+{
+	current = SaveCheckpoint();
+	deltaSavesCount = 0;
+}
+
+boost::filesystem::path CSaveCheckpoints::getPath(const boost::filesystem::path & directory, const SaveCheckpoint & checkpoint, const std::string & extension)
+{
+	return directory / (checkpoint.name + extension);
+}
+
+bool CSaveCheckpoints::isCheckpointFile(const boost::filesystem::path & path)
+{
+	return boost::starts_with(path.filename().string(), CHECKPOINT_PREFIX);
+}
+
+void CSaveCheckpoints::removeUnused(const boost::filesystem::path & directory, const std::string & extension, const TCheckpointReader & getCheckpointName) const
+{
+	std::set<std::string> used;
+	std::vector<boost::filesystem::path> checkpoints;
+	used.insert(current.name);
+
+	boost::system::error_code ec;
+	for(boost::filesystem::directory_iterator it(directory, ec), end; it != end; it.increment(ec))
+	{
+		const boost::filesystem::path & path = it->path();
+		if(path.extension().string() != extension)
+			continue;
+
+		if(isCheckpointFile(path))
+			checkpoints.push_back(path);
+		else
+			used.insert(getCheckpointName(path));
+	}
+
+	for(auto & path : checkpoints)
+	{
+		if(!vstd::contains(used, path.stem().string()))
+		{
+			logGlobal->info("Removing unused checkpoint %s", path.string());
+			boost::filesystem::remove(path, ec);
+		}
+	}
+}
+
+CPackJournal::CPackJournal()
+	: packsCount(0), fileVersion(SERIALIZATION_VERSION), reverseEndianess(false), oser(this)
+{
+	registerTypes(oser);
+	oser.smartPointerSerialization = false;
+	sendStackInstanceByIds = true;
+}
+
+int CPackJournal::write(const void * data, unsigned size)
+{
+	auto oldSize = buffer.size();
+	buffer.resize(oldSize + size);
+	std::memcpy(buffer.data() + oldSize, data, size);
+	return size;
+}
+
+void CPackJournal::reset(CGameState * gs)
+{
+	buffer.clear();
+	packsCount = 0;
+	fileVersion = SERIALIZATION_VERSION;
+	reverseEndianess = false;
+	addStdVecItems(gs);
+}
+
+void CPackJournal::record(const CPack * pack)
+{
+	assert(smartVectorMembersSerialization); //reset() was not called
+	oser & pack;
+	packsCount++;
+}
+
+ui32 CPackJournal::size() const
+{
+	return packsCount;
+}
+
+size_t CPackJournal::sizeInBytes() const
+{
+	return buffer.size();
+}
+
+void CPackJournal::replay(CGameState * gs) const
+{
+	CJournalReader reader(buffer);
+	reader.iser.fileVersion = fileVersion;
+	reader.iser.reverseEndianess = reverseEndianess;
+	reader.iser.smartPointerSerialization = false;
+	reader.sendStackInstanceByIds = true;
+	reader.addStdVecItems(gs);
+
+	for(ui32 i = 0; i < packsCount; i++)
+	{
+		CPack * pack = nullptr;
+		reader.iser & pack;
+		if(!pack)
+			throw std::runtime_error("Pack journal is corrupted!");
+
+		gs->apply(pack);
+		delete pack;
+	}
+	logGlobal->debug("Replayed %d packs (%d bytes) from journal", packsCount, buffer.size());
+}
+
+void CPackJournal::serialize(BinarySerializer & h, const int version)
+{
+	ui32 length = static_cast<ui32>(buffer.size());
+	h & packsCount;
+	h & length;
+	h.write(buffer.data(), length);
+}
+
+void CPackJournal::serialize(BinaryDeserializer & h, const int version)
+{
+	ui32 length = 0;
+	h & packsCount;
+	h & length;
+	buffer.resize(length);
+	h.read(buffer.data(), length);
+
+	fileVersion = version;
+	reverseEndianess = h.reverseEndianess;
+}
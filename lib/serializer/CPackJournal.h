@@ -0,0 +1,93 @@
+/*
+ * CPackJournal.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "BinarySerializer.h"
+#include "BinaryDeserializer.h"
+
+struct CPack;
+class CGameState;
+
+/// Identifies full save that delta saves are based on
+struct DLL_LINKAGE SaveCheckpoint
+{
+	std::string name; //name of checkpoint file, without directory and extension. Checkpoint file is in the same directory as delta saves
+	ui64 token; //random value written into full save, allows to detect overwritten checkpoints
+
+	SaveCheckpoint();
+
+	bool empty() const;
+
+	template <typename Handler> void serialize(Handler & h, const int version)
+	{
+		h & name;
+		h & token;
+	}
+};
+
+/// Checkpoint of delta autosaves. Game state of checkpoint is stored in file of its own with name made from its token,
+/// so rotation of autosaves or manual save under any name never overwrites checkpoint that existing delta saves need
+class DLL_LINKAGE CSaveCheckpoints
+{
+	SaveCheckpoint current;
+	ui32 deltaSavesCount; //delta saves made since current checkpoint was started
+public:
+	/// returns name of checkpoint that given save file refers to, empty for full saves
+	using TCheckpointReader = std::function<std::string(const boost::filesystem::path &)>;
+
+	CSaveCheckpoints();
+
+	const SaveCheckpoint & getCurrent() const;
+
+	/// true if next delta save in directory can refer to current checkpoint
+	bool canSaveDelta(const boost::filesystem::path & directory, const std::string & extension, ui32 maxDeltaSaves) const;
+	/// replaces current checkpoint with new one, its full save must be written to getPath
+	const SaveCheckpoint & startCheckpoint();
+	void deltaSaved();
+	/// forgets current checkpoint, e.g. if its file could not be written
+	void clear();
+
+	static boost::filesystem::path getPath(const boost::filesystem::path & directory, const SaveCheckpoint & checkpoint, const std::string & extension);
+	static bool isCheckpointFile(const boost::filesystem::path & path);
+
+	/// Removes checkpoint files in directory that are neither current nor referred by any save in the same directory
+	void removeUnused(const boost::filesystem::path & directory, const std::string & extension, const TCheckpointReader & getCheckpointName) const;
+};
+
+/// Sequence of packs applied on game state, stored in the same form as on gameplay connection.
+/// Allows restoring game state by replaying packs on top of an older state
+class DLL_LINKAGE CPackJournal : public IBinaryWriter
+{
+	std::vector<ui8> buffer;
+	ui32 packsCount;
+
+	//format of loaded packs, may be older than current one
+	si32 fileVersion;
+	bool reverseEndianess;
+
+	BinarySerializer oser;
+
+	int write(const void * data, unsigned size) override;
+public:
+	CPackJournal();
+
+	/// Drops all recorded packs, following packs will be recorded against given game state
+	void reset(CGameState * gs);
+	void record(const CPack * pack);
+
+	ui32 size() const;
+	size_t sizeInBytes() const;
+
+	/// Applies all recorded packs on game state in order of recording
+	void replay(CGameState * gs) const;
+
+	void serialize(BinarySerializer & h, const int version);
+	void serialize(BinaryDeserializer & h, const int version);
+};
@@ -0,0 +1,103 @@
+/*
+ * CStateDigest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CStateDigest.h"
+
+#include "../registerTypes/RegisterTypes.h"
+#include "../CGameState.h"
+#include "../CPlayerState.h"
+#include "../NetPacksBase.h"
+#include "../mapObjects/CGHeroInstance.h"
+#include "../mapObjects/CGTownInstance.h"
+
+CStateDigest::CStateDigest()
+	: packsCount(0), oser(this)
+{
+	registerTypes(oser);
+	oser.smartPointerSerialization = false;
+	sendStackInstanceByIds = true;
+}
+
+int CStateDigest::write(const void * data, unsigned size)
+{
+	crc.process_bytes(data, size);
+	return size;
+}
+
+void CStateDigest::update(CGameState * gs, const CPack * pack)
+{
+	if(!smartVectorMembersSerialization)
+		addStdVecItems(gs);
+
+	oser & pack;
+	packsCount++;
+}
+
+ui32 CStateDigest::value() const
+{
+	return crc.checksum();
+}
+
+ui32 CStateDigest::size() const
+{
+	return packsCount;
+}
+
+ui32 CStateDigest::summary(const CGameState * gs)
+{
+	boost::crc_32_type result;
+	auto process = [&result](si64 value)
+	{
+		result.process_bytes(&value, sizeof(value));
+	};
+
+	auto processArmy = [&](const CCreatureSet * army)
+	{
+		for(auto & slot : army->Slots())
+		{
+			process(slot.first.getNum());
+			process(slot.second->getCreatureID().toEnum());
+			process(slot.second->count);
+		}
+	};
+
+	process(gs->day);
+	process(gs->currentPlayer.getNum());
+
+	for(auto & elem : gs->players)
+	{
+		const PlayerState & player = elem.second;
+		process(elem.first.getNum());
+		process(player.status);
+
+		for(auto amount : player.resources)
+			process(amount);
+
+		for(auto & hero : player.heroes)
+		{
+			process(hero->id.getNum());
+			process(hero->pos.x);
+			process(hero->pos.y);
+			process(hero->pos.z);
+			process(hero->mana);
+			process(hero->movement);
+			process(hero->exp);
+			processArmy(hero);
+		}
+
+		for(auto & town : player.towns)
+		{
+			process(town->id.getNum());
+			process(town->builtBuildings.size());
+			processArmy(town);
+		}
+	}
+	return result.checksum();
+}
@@ -0,0 +1,40 @@
+/*
+ * CStateDigest.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "BinarySerializer.h"
+
+#include <boost/crc.hpp>
+
+struct CPack;
+class CGameState;
+
+/// Running checksum of all packs that changed game state, updated incrementally when pack is applied.
+/// Server and clients apply the same packs in the same order, so different digests mean that their states have diverged
+class DLL_LINKAGE CStateDigest : public IBinaryWriter
+{
+	boost::crc_32_type crc;
+	ui32 packsCount;
+	BinarySerializer oser;
+
+	int write(const void * data, unsigned size) override;
+public:
+	CStateDigest();
+
+	/// Must be called before pack is applied, packs are hashed in form in which they are sent over network
+	void update(CGameState * gs, const CPack * pack);
+
+	ui32 value() const;
+	ui32 size() const;
+
+	/// Cheap checksum of most frequently changing parts of game state: resources, heroes and towns.
+	/// Catches differences caused by non-deterministic applyGs that are not visible in packs themselves
+	static ui32 summary(const CGameState * gs);
+};
@@ -17,8 +17,10 @@ extern template void registerTypes<CTypeList>(CTypeList & s);
 CTypeList typeList;
 
 CTypeList::CTypeList()
+	: castTable(nullptr)
 {
 	registerTypes(*this);
+	getCastTable();
 }
 
 CTypeList::TypeInfoPtr CTypeList::registerType(const std::type_info *type)
@@ -45,16 +47,21 @@ ui16 CTypeList::getTypeID(const std::type_info *type, bool throws) const
 	return descriptor->typeID;
 }
 
-std::vector<CTypeList::TypeInfoPtr> CTypeList::castSequence(TypeInfoPtr from, TypeInfoPtr to) const
+std::unique_ptr<const CTypeList::CastTable> CTypeList::buildCastTable() const
 {
-	if(!strcmp(from->name, to->name))
-		return std::vector<CTypeList::TypeInfoPtr>();
+	std::vector<TypeInfoPtr> types(typeInfos.size() + 1); //type ID 0 is not used
+	for(auto & typeInfo : typeInfos)
+		types[typeInfo.second->typeID] = typeInfo.second;
 
-	// Perform a simple BFS in the class hierarchy.
+	auto table = make_unique<CastTable>();
+	table->width = types.size();
+	table->offsets.reserve(table->width * table->width + 1);
 
-	auto BFS = [&](bool upcast)
+	// Perform a simple BFS in the class hierarchy, starting from target type.
+	// previous[from] is the next type on the way from "from" to "to"
+	auto BFS = [&](const TypeInfoPtr & to, bool upcast, std::vector<ui16> & previous)
 	{
-		std::map<TypeInfoPtr, TypeInfoPtr> previous;
+		std::fill(previous.begin(), previous.end(), 0);
 		std::queue<TypeInfoPtr> q;
 		q.push(to);
 		while(q.size())
@@ -64,49 +71,62 @@ std::vector<CTypeList::TypeInfoPtr> CTypeList::castSequence(TypeInfoPtr from, Ty
 			for(auto & weakNode : (upcast ? typeNode->parents : typeNode->children) )
 			{
 				auto nodeBase = weakNode.lock();
-				if(!previous.count(nodeBase))
+				if(nodeBase != to && !previous[nodeBase->typeID])
 				{
-					previous[nodeBase] = typeNode;
+					previous[nodeBase->typeID] = typeNode->typeID;
 					q.push(nodeBase);
 				}
 			}
 		}
+	};
 
-		std::vector<TypeInfoPtr> ret;
-
-		if(!previous.count(from))
-			return ret;
+	// sequences for all "from" types are stored together, so resolve them for each "to" first
+	std::vector<std::vector<ui16>> up(table->width, std::vector<ui16>(table->width)), down = up;
+	for(size_t to = 1; to < table->width; to++)
+	{
+		BFS(types[to], true, up[to]);
+		BFS(types[to], false, down[to]);
+	}
 
-		ret.push_back(from);
-		TypeInfoPtr ptr = from;
-		do
+	for(size_t from = 0; from < table->width; from++)
+	{
+		for(size_t to = 0; to < table->width; to++)
 		{
-			ptr = previous.at(ptr);
-			ret.push_back(ptr);
-		} while(ptr != to);
-
-		return ret;
-	};
+			table->offsets.push_back(static_cast<ui32>(table->steps.size()));
+			if(from == 0 || to == 0 || from == to)
+				continue;
 
-	// Try looking both up and down.
-	auto ret = BFS(true);
-	if(ret.empty())
-		ret = BFS(false);
-
-	if(ret.empty())
-		THROW_FORMAT("Cannot find relation between types %s and %s. Were they (and all classes between them) properly registered?", from->name % to->name);
+			// Try looking both up and down.
+			const auto & previous = up[to][from] ? up[to] : down[to];
+			for(size_t current = from; current != to; current = previous[current])
+			{
+				if(!previous[current])
+					break; //types are not related
+				auto castingPair = std::make_pair(types[current], types[previous[current]]);
+				table->steps.push_back(casters.at(castingPair).get());
+			}
+		}
+	}
+	table->offsets.push_back(static_cast<ui32>(table->steps.size()));
 
-	return ret;
+	return table;
 }
 
-std::vector<CTypeList::TypeInfoPtr> CTypeList::castSequence(const std::type_info *from, const std::type_info *to) const
+const CTypeList::CastTable & CTypeList::getCastTable() const
 {
-	//This additional if is needed because getTypeDescriptor might fail if type is not registered
-	// (and if casting is not needed, then registereing should no  be required)
-	if(!strcmp(from->name(), to->name()))
-		return std::vector<CTypeList::TypeInfoPtr>();
+	const CastTable * table = castTable.load(std::memory_order_acquire);
+	if(table)
+		return *table;
 
-	return castSequence(getTypeDescriptor(from), getTypeDescriptor(to));
+	TUniqueLock lock(mx);
+	table = castTable.load(std::memory_order_acquire);
+	if(!table)
+	{
+		castTables.push_back(buildCastTable());
+		table = castTables.back().get();
+		castTable.store(table, std::memory_order_release);
+	}
+	return *table;
 }
 
 CTypeList::TypeInfoPtr CTypeList::getTypeDescriptor(const std::type_info *type, bool throws) const
@@ -71,6 +71,14 @@ class DLL_LINKAGE CTypeList: public boost::noncopyable
 		const char *name;
 		std::vector<WeakTypeInfoPtr> children, parents;
 	};
+	/// Casters needed to convert pointer between every pair of registered types, indexed by type IDs.
+	/// Table is immutable once built, so it can be read without locking
+	struct CastTable
+	{
+		size_t width; //type IDs are in range [0, width)
+		std::vector<ui32> offsets; //casters for pair (from, to) are steps[offsets[from * width + to]] .. steps[offsets[from * width + to + 1]]
+		std::vector<const IPointerCaster *> steps;
+	};
 	typedef boost::shared_mutex TMutex;
 	typedef boost::unique_lock<TMutex> TUniqueLock;
 	typedef boost::shared_lock<TMutex> TSharedLock;
@@ -80,30 +88,40 @@ private:
 	std::map<const std::type_info *, TypeInfoPtr, TypeComparer> typeInfos;
 	std::map<std::pair<TypeInfoPtr, TypeInfoPtr>, std::unique_ptr<const IPointerCaster>> casters; //for each pair <Base, Der> we provide a caster (each registered relations creates a single entry here)
 
-	/// Returns sequence of types starting from "from" and ending on "to". Every next type is derived from the previous.
-	/// Throws if there is no link registered.
-	std::vector<TypeInfoPtr> castSequence(TypeInfoPtr from, TypeInfoPtr to) const;
-	std::vector<TypeInfoPtr> castSequence(const std::type_info *from, const std::type_info *to) const;
+	mutable std::atomic<const CastTable *> castTable; //nullptr if table needs to be rebuilt
+	mutable std::vector<std::unique_ptr<const CastTable>> castTables; //all tables ever built, outdated ones may still be in use by other threads
+
+	/// Builds cast sequences for all pairs of types. In every sequence next type is derived from the previous one or vice versa
+	std::unique_ptr<const CastTable> buildCastTable() const;
+	const CastTable & getCastTable() const;
 
 	template<boost::any(IPointerCaster::*CastingFunction)(const boost::any &) const>
 	boost::any castHelper(boost::any inputPtr, const std::type_info *fromArg, const std::type_info *toArg) const
 	{
-		TSharedLock lock(mx);
-		auto typesSequence = castSequence(fromArg, toArg);
+		//This additional if is needed because getTypeID might fail if type is not registered
+		// (and if casting is not needed, then registereing should no  be required)
+		if(!strcmp(fromArg->name(), toArg->name()))
+			return inputPtr;
 
-		boost::any ptr = inputPtr;
-		for(int i = 0; i < static_cast<int>(typesSequence.size()) - 1; i++)
+		const CastTable & table = getCastTable();
+		const size_t fromID = getTypeID(fromArg, true);
+		const size_t toID = getTypeID(toArg, true);
+
+		// type registered after table was built has no casters in it
+		ui32 first = 0, last = 0;
+		if(fromID < table.width && toID < table.width)
 		{
-			auto &from = typesSequence[i];
-			auto &to = typesSequence[i + 1];
-			auto castingPair = std::make_pair(from, to);
-			if(!casters.count(castingPair))
-				THROW_FORMAT("Cannot find caster for conversion %s -> %s which is needed to cast %s -> %s", from->name % to->name % fromArg->name() % toArg->name());
-
-			auto &caster = casters.at(castingPair);
-			ptr = (*caster.*CastingFunction)(ptr); //Why does unique_ptr not have operator->* ..?
+			first = table.offsets[fromID * table.width + toID];
+			last = table.offsets[fromID * table.width + toID + 1];
 		}
 
+		if(first == last)
+			THROW_FORMAT("Cannot find relation between types %s and %s. Were they (and all classes between them) properly registered?", fromArg->name() % toArg->name());
+
+		boost::any ptr = inputPtr;
+		for(ui32 i = first; i < last; i++)
+			ptr = (table.steps[i]->*CastingFunction)(ptr);
+
 		return ptr;
 	}
 	CTypeList &operator=(CTypeList &)
@@ -132,11 +150,16 @@ public:
 		auto bti = registerType(bt);
 		auto dti = registerType(dt); //obtain our TypeDescriptor
 
+		//appliers register the same relations again, they are already in cast table
+		if(casters.count(std::make_pair(bti, dti)))
+			return;
+
 		// register the relation between classes
 		bti->children.push_back(dti);
 		dti->parents.push_back(bti);
 		casters[std::make_pair(bti, dti)] = make_unique<const PointerCaster<Base, Derived>>();
 		casters[std::make_pair(dti, bti)] = make_unique<const PointerCaster<Derived, Base>>();
+		castTable = nullptr;
 	}
 
 	ui16 getTypeID(const std::type_info *type, bool throws = false) const;
@@ -578,7 +578,7 @@ ESpellCastResult ViewMechanics::applyAdventureEffects(const SpellCastEnvironment
 		{
 			ObjectPosInfo posInfo(obj);
 
-			if(fowMap[posInfo.pos.x][posInfo.pos.y][posInfo.pos.z] == 0)
+			if(!fowMap.contains(posInfo.pos))
 				pack.objectPositions.push_back(posInfo);
 		}
 	}
@@ -15,6 +15,7 @@
 #include "../lib/mapping/CCampaignHandler.h"
 #include "../lib/StartInfo.h"
 #include "../lib/CModHandler.h"
+#include "../lib/CConfigHandler.h"
 #include "../lib/CArtHandler.h"
 #include "../lib/CBuildingHandler.h"
 #include "../lib/CHeroHandler.h"
@@ -40,11 +41,13 @@
 #include "../lib/CSoundBase.h"
 #include "CGameHandler.h"
 #include "CVCMIServer.h"
+#include "CGameJournal.h"
 #include "../lib/CCreatureSet.h"
 #include "../lib/CThreadHelper.h"
 #include "../lib/GameConstants.h"
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "../lib/serializer/CTypeList.h"
+#include "../lib/serializer/CStateDigest.h"
 #include "../lib/serializer/Connection.h"
 #include "../lib/serializer/Cast.h"
 #include "../lib/serializer/JsonSerializer.h"
@@ -218,6 +221,52 @@ public:
 	}
 };
 
+template <typename T> class CPackFilter;
+
+class CBaseForPackFilter
+{
+public:
+	virtual bool isFiltered() const =0; //if false, pack is sent to all clients
+	virtual bool visibleTo(CGameHandler * gh, const void * pack, PlayerColor player) const =0;
+	virtual ~CBaseForPackFilter(){}
+	template<typename U> static CBaseForPackFilter *getApplier(const U * t=nullptr)
+	{
+		return new CPackFilter<U>();
+	}
+};
+
+template <typename T> class CPackFilter : public CBaseForPackFilter
+{
+	//packs that change game state are needed by every client to keep its copy of game state in sync
+	static const bool filtered = !std::is_same<decltype(&T::visibleTo), bool (CPackForClient::*)(CGameHandler *, PlayerColor) const>::value
+		&& std::is_same<decltype(&T::applyGs), void (CPack::*)(CGameState *)>::value;
+public:
+	bool isFiltered() const override
+	{
+		return filtered;
+	}
+
+	bool visibleTo(CGameHandler * gh, const void * pack, PlayerColor player) const override
+	{
+		return static_cast<const T *>(pack)->visibleTo(gh, player);
+	}
+};
+
+template <>
+class CPackFilter<CPack> : public CBaseForPackFilter
+{
+public:
+	bool isFiltered() const override
+	{
+		return false;
+	}
+
+	bool visibleTo(CGameHandler * gh, const void * pack, PlayerColor player) const override
+	{
+		return true;
+	}
+};
+
 static inline double distance(int3 a, int3 b)
 {
 	return std::sqrt((double)(a.x-b.x)*(a.x-b.x) + (a.y-b.y)*(a.y-b.y));
@@ -1216,6 +1265,13 @@ void CGameHandler::handleClientDisconnection(std::shared_ptr<CConnection> c)
 
 void CGameHandler::handleReceivedPack(CPackForServer * pack)
 {
+	if(journal)
+	{
+		const si32 seed = journal->generateSeed();
+		journal->recordRequest(gs, pack, getPlayerAt(pack->c), appliedPacksCount, seed);
+		getRandomGenerator().setSeed(seed);
+	}
+
 	//prepare struct informing that action was applied
 	auto sendPackageResponse = [&](bool succesfullyApplied)
 	{
@@ -1224,7 +1280,8 @@ void CGameHandler::handleReceivedPack(CPackForServer * pack)
 		applied.result = succesfullyApplied;
 		applied.packType = typeList.getTypeID(pack);
 		applied.requestID = pack->requestID;
-		pack->c->sendPack(&applied);
+		if(pack->c) //replayed requests have no connection
+			pack->c->sendPack(&applied);
 	};
 
 	CBaseForGHApply * apply = applier->getApplier(typeList.getTypeID(pack)); //and appropriate applier object
@@ -1521,9 +1578,14 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 	: lobby(lobby)
 {
 	QID = 1;
+	appliedPacksCount = 0;
+	replay = nullptr;
 	IObjectInterface::cb = this;
 	applier = std::make_shared<CApplier<CBaseForGHApply>>();
 	registerTypesServerPacks(*applier);
+	packFilter = std::make_shared<CApplier<CBaseForPackFilter>>();
+	registerTypesClientPacks1(*packFilter);
+	registerTypesClientPacks2(*packFilter);
 	visitObjectAfterVictory = false;
 
 	spellEnv = new ServerSpellCastEnvironment(this);
@@ -1531,6 +1593,8 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 
 CGameHandler::~CGameHandler()
 {
+	if(journal)
+		journal->finish(appliedPacksCount);
 	delete spellEnv;
 	delete gs;
 }
@@ -1541,6 +1605,10 @@ void CGameHandler::init(StartInfo *si)
 	{
 		si->seedToBeUsed = static_cast<ui32>(std::time(nullptr));
 	}
+	if(journal)
+		journal->start(*si);
+	reseedRandomGenerator(EJournalThread::GAME);
+
 	CMapService mapService;
 	gs = new CGameState();
 	logGlobal->info("Gamestate created!");
@@ -1549,6 +1617,7 @@ void CGameHandler::init(StartInfo *si)
 
 	// reset seed, so that clients can't predict any following random values
 	getRandomGenerator().resetSeed();
+	reseedRandomGenerator(EJournalThread::GAME);
 
 	for (auto & elem : gs->players)
 	{
@@ -1605,6 +1674,11 @@ void CGameHandler::setPortalDwelling(const CGTownInstance * town, bool forced=fa
 void CGameHandler::newTurn()
 {
 	logGlobal->trace("Turn %d", gs->day+1);
+	if(replay)
+		replay->turnStarted(gs);
+	reseedRandomGenerator(EJournalThread::GAME);
+	sendStateDigest();
+
 	NewTurn n;
 	n.specialWeek = NewTurn::NO_ACTION;
 	n.creatureid = CreatureID::NONE;
@@ -1618,12 +1692,10 @@ void CGameHandler::newTurn()
 
 	if (firstTurn)
 	{
-		for (auto obj : gs->map->objects)
+		auto prisons = gs->map->objectIndex.getObjectsOfType(Obj::PRISON); //copy, applied packs may change the index
+		for (auto obj : prisons) //give imprisoned hero 0 exp to level him up. easiest to do at this point
 		{
-			if (obj && obj->ID == Obj::PRISON) //give imprisoned hero 0 exp to level him up. easiest to do at this point
-			{
-				changePrimSkill (getHero(obj->id), PrimarySkill::EXPERIENCE, 0);
-			}
+			changePrimSkill (getHero(obj->id), PrimarySkill::EXPERIENCE, 0);
 		}
 	}
 
@@ -1869,12 +1941,8 @@ void CGameHandler::newTurn()
 				fw.mode = 1;
 				fw.player = player;
 				// find all hidden tiles
-				const auto & fow = getPlayerTeam(player)->fogOfWarMap;
-				for (size_t i=0; i<fow.size(); i++)
-					for (size_t j=0; j<fow.at(i).size(); j++)
-						for (size_t k=0; k<fow.at(i).at(j).size(); k++)
-							if (!fow.at(i).at(j).at(k))
-								fw.tiles.insert(int3((si32)i,(si32)j,(si32)k));
+				getAllTiles(fw.tiles, player);
+				fw.tiles -= getPlayerTeam(player)->fogOfWarMap;
 
 				sendAndApply (&fw);
 			}
@@ -2743,18 +2811,40 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient * pack)
 {
 	logNetwork->trace("\tSending to all clients: %s", typeid(*pack).name());
+	CBaseForPackFilter * filter = packFilter->getApplier(typeList.getTypeID(pack));
 	for (auto c : lobby->connections)
 	{
 		if(!c->isOpen())
 			continue;
 
+		if(filter->isFiltered() && !isPackVisibleToClient(filter, pack, c->connectionID))
+		{
+			logNetwork->trace("\tPack %s is not sent to connection %d", typeid(*pack).name(), c->connectionID);
+			continue;
+		}
+
 		c->sendPack(pack);
 	}
 }
 
+bool CGameHandler::isPackVisibleToClient(CBaseForPackFilter * filter, const CPackForClient * pack, int connectionID)
+{
+	auto players = lobby->getAllClientPlayers(connectionID);
+	if(players.empty()) //spectators receive everything
+		return true;
+
+	for(auto player : players)
+	{
+		if(filter->visibleTo(this, pack, player))
+			return true;
+	}
+	return false;
+}
+
 void CGameHandler::sendAndApply(CPackForClient * pack)
 {
 	sendToAllClients(pack);
+	recordAppliedPack(pack);
 	gs->apply(pack);
 	logNetwork->trace("\tApplied on gs: %s", typeid(*pack).name());
 }
@@ -2763,6 +2853,29 @@ void CGameHandler::applyAndSend(CPackForClient * pack)
 {
 	gs->apply(pack);
 	sendToAllClients(pack);
+	//clients receive this pack after it was applied, journal must store the same data
+	recordAppliedPack(pack);
+}
+
+void CGameHandler::recordAppliedPack(const CPackForClient * pack)
+{
+	if(!checkpoints.getCurrent().empty())
+		checkpointJournal.record(pack);
+	appliedPacksCount++;
+	if(replay)
+		replay->onPackApplied();
+}
+
+void CGameHandler::sendStateDigest()
+{
+	GameStateDigest gsd;
+	{
+		boost::shared_lock<boost::shared_mutex> lock(CGameState::mutex);
+		gsd.packsCount = gs->getStateDigest().size();
+		gsd.digest = gs->getStateDigest().value();
+		gsd.summary = CStateDigest::summary(gs);
+	}
+	sendAndApply(&gsd);
 }
 
 void CGameHandler::sendAndApply(CGarrisonOperationPack * pack)
@@ -2783,32 +2896,77 @@ void CGameHandler::sendAndApply(NewStructures * pack)
 	checkVictoryLossConditionsForPlayer(getTown(pack->tid)->tempOwner);
 }
 
-void CGameHandler::save(const std::string & filename)
+void CGameHandler::save(const std::string & filename, bool allowDelta)
 {
-	logGlobal->info("Loading from %s", filename);
+	logGlobal->info("Saving to %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
 	const auto savefname = stem.to_string() + ".vsgm1";
 	CResourceHandler::get("local")->createResource(savefname);
 
+	const auto maxDeltaSaves = static_cast<ui32>(settings["server"]["deltaSaves"].Integer());
+	const auto savePath = *CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME));
+	const auto saveDirectory = savePath.parent_path();
+	const auto extension = savePath.extension().string();
+
+	//autosaves are deltas of checkpoint that is started again after every maxDeltaSaves of them
+	const bool delta = allowDelta && maxDeltaSaves > 0;
+	const bool newCheckpoint = delta && !checkpoints.canSaveDelta(saveDirectory, extension, maxDeltaSaves);
+	if(newCheckpoint)
+		checkpoints.startCheckpoint();
+
 	{
 		logGlobal->info("Ordering clients to serialize...");
 		SaveGameClient sg(savefname);
+		sg.delta = delta;
+		sg.checkpoint = delta ? checkpoints.getCurrent() : SaveCheckpoint();
 		sendToAllClients(&sg);
 	}
 
 	try
 	{
+		if(newCheckpoint)
+		{
+			logGlobal->info("Saving checkpoint %s", checkpoints.getCurrent().name);
+			CSaveFile save(CSaveCheckpoints::getPath(saveDirectory, checkpoints.getCurrent(), extension));
+			saveCommonState(save, checkpoints.getCurrent());
+			checkpointJournal.reset(gs);
+		}
 		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(ResourceID(stem.to_string(), EResType::SERVER_SAVEGAME)));
-			saveCommonState(save);
+			CSaveFile save(savePath);
+			if(delta)
+			{
+				saveCommonStateDelta(save, checkpoints.getCurrent(), &checkpointJournal);
+				checkpoints.deltaSaved();
+			}
+			else
+			{
+				saveCommonState(save, SaveCheckpoint());
+			}
 			logGlobal->info("Saving server state");
 			save << *this;
 		}
+		if(newCheckpoint)
+		{
+			checkpoints.removeUnused(saveDirectory, extension, [](const boost::filesystem::path & path) -> std::string
+			{
+				try
+				{
+					return getDeltaCheckpointName(path);
+				}
+				catch(std::exception & e)
+				{
+					logGlobal->warn("Failed to read checkpoint of %s: %s", path.string(), e.what());
+					return "";
+				}
+			});
+		}
 		logGlobal->info("Game has been successfully saved!");
 	}
 	catch(std::exception &e)
 	{
 		logGlobal->error("Failed to save game: %s", e.what());
+		//following delta saves would refer to broken checkpoint
+		checkpoints.clear();
 	}
 }
 
@@ -2816,6 +2974,9 @@ void CGameHandler::load(const std::string & filename)
 {
 	logGlobal->info("Loading from %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
+	if(journal)
+		journal->start(*lobby->si);
+	reseedRandomGenerator(EJournalThread::GAME);
 
 	try
 	{
@@ -2975,6 +3136,9 @@ bool CGameHandler::arrangeStacks(ObjectInstanceID id1, ObjectInstanceID id2, ui8
 
 PlayerColor CGameHandler::getPlayerAt(std::shared_ptr<CConnection> c) const
 {
+	if(replay && !c)
+		return replay->currentSender();
+
 	std::set<PlayerColor> all;
 	for (auto i=connections.cbegin(); i!=connections.cend(); i++)
 		if(vstd::contains(i->second, c))
@@ -5916,6 +6080,7 @@ bool CGameHandler::swapStacks(const StackLocation & sl1, const StackLocation & s
 
 void CGameHandler::runBattle()
 {
+	reseedRandomGenerator(EJournalThread::BATTLE);
 	setBattle(gs->curB);
 	assert(gs->curB);
 	//TODO: pre-tactic stuff, call scripts etc.
@@ -6533,16 +6698,9 @@ void CGameHandler::handleCheatCode(std::string & cheat, PlayerColor player, cons
 		FoWChange fc;
 		fc.mode = (cheat == "vcmieagles" ? 1 : 0);
 		fc.player = player;
-		const auto & fowMap = gs->getPlayerTeam(player)->fogOfWarMap;
-		auto hlp_tab = new int3[gs->map->width * gs->map->height * (gs->map->twoLevel ? 2 : 1)];
-		int lastUnc = 0;
-		for (int i = 0; i < gs->map->width; i++)
-			for (int j = 0; j < gs->map->height; j++)
-				for (int k = 0; k < (gs->map->twoLevel ? 2 : 1); k++)
-					if (!fowMap.at(i).at(j).at(k) || !fc.mode)
-						hlp_tab[lastUnc++] = int3(i, j, k);
-		fc.tiles.insert(hlp_tab, hlp_tab + lastUnc);
-		delete [] hlp_tab;
+		getAllTiles(fc.tiles, player);
+		if (fc.mode)
+			fc.tiles -= gs->getPlayerTeam(player)->fogOfWarMap;
 		sendAndApply(&fc);
 	}
 	else
@@ -6607,11 +6765,11 @@ void CGameHandler::removeAfterVisit(const CGObjectInstance *object)
 
 void CGameHandler::changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide)
 {
-	std::unordered_set<int3, ShashInt3> tiles;
+	CTileSet tiles;
 	getTilesInRange(tiles, center, radius, player, hide? -1 : 1);
 	if (hide)
 	{
-		std::unordered_set<int3, ShashInt3> observedTiles; //do not hide tiles observed by heroes. May lead to disastrous AI problems
+		CTileSet observedTiles; //do not hide tiles observed by heroes. May lead to disastrous AI problems
 		auto p = getPlayer(player);
 		for (auto h : p->heroes)
 		{
@@ -6621,13 +6779,12 @@ void CGameHandler::changeFogOfWar(int3 center, ui32 radius, PlayerColor player,
 		{
 			getTilesInRange(observedTiles, t->getSightCenter(), t->getSightRadius(), t->tempOwner, -1);
 		}
-		for (auto tile : observedTiles)
-			vstd::erase_if_present (tiles, tile);
+		tiles -= observedTiles;
 	}
 	changeFogOfWar(tiles, player, hide);
 }
 
-void CGameHandler::changeFogOfWar(std::unordered_set<int3, ShashInt3> &tiles, PlayerColor player, bool hide)
+void CGameHandler::changeFogOfWar(const CTileSet &tiles, PlayerColor player, bool hide)
 {
 	FoWChange fow;
 	fow.tiles = tiles;
@@ -6811,6 +6968,19 @@ CRandomGenerator & CGameHandler::getRandomGenerator()
 	return CRandomGenerator::getDefault();
 }
 
+void CGameHandler::reseedRandomGenerator(EJournalThread::EJournalThread thread)
+{
+	if(replay)
+		getRandomGenerator().setSeed(replay->nextSeed(thread));
+	else if(journal)
+		getRandomGenerator().setSeed(journal->recordSeed(thread));
+}
+
+ui32 CGameHandler::getAppliedPacksCount() const
+{
+	return appliedPacksCount;
+}
+
 ///ServerSpellCastEnvironment
 ServerSpellCastEnvironment::ServerSpellCastEnvironment(CGameHandler * gh): gh(gh)
 {
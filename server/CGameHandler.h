@@ -12,7 +12,9 @@
 #include "../lib/FunctionList.h"
 #include "../lib/IGameCallback.h"
 #include "../lib/battle/BattleAction.h"
+#include "../lib/serializer/CPackJournal.h"
 #include "CQuery.h"
+#include "CGameJournal.h"
 
 class CGameHandler;
 class CVCMIServer;
@@ -32,6 +34,7 @@ class SpellCastEnvironment;
 
 template<typename T> class CApplier;
 class CBaseForGHApply;
+class CBaseForPackFilter;
 
 struct PlayerStatus
 {
@@ -79,6 +82,16 @@ class CGameHandler : public IGameCallback, CBattleInfoCallback
 {
 	CVCMIServer * lobby;
 	std::shared_ptr<CApplier<CBaseForGHApply>> applier;
+	std::shared_ptr<CApplier<CBaseForPackFilter>> packFilter; //decides which clients receive which packs
+
+	CSaveCheckpoints checkpoints; //checkpoint of delta autosaves, empty if delta saves are disabled
+	CPackJournal checkpointJournal; //packs applied on game state since current checkpoint
+
+	std::atomic<ui32> appliedPacksCount; //number of packs applied on game state, used as synchronization point for replays
+
+	void recordAppliedPack(const CPackForClient * pack);
+	void sendStateDigest(); //lets clients verify that their game state matches ours
+	bool isPackVisibleToClient(CBaseForPackFilter * filter, const CPackForClient * pack, int connectionID);
 public:
 	using FireShieldInfo = std::vector<std::pair<const CStack *, int64_t>>;
 	//use enums as parameters, because doMove(sth, true, false, true) is not readable
@@ -96,6 +109,9 @@ public:
 
 	SpellCastEnvironment * spellEnv;
 
+	std::unique_ptr<CGameJournal> journal; //records received requests if enabled
+	CGameReplay * replay; //source of requests if game is replayed from journal
+
 	bool isValidObject(const CGObjectInstance *obj) const;
 	bool isBlockedByQueries(const CPack *pack, PlayerColor player);
 	bool isAllowedExchange(ObjectInstanceID id1, ObjectInstanceID id2);
@@ -172,7 +188,7 @@ public:
 	void heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2) override;
 
 	void changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide) override;
-	void changeFogOfWar(std::unordered_set<int3, ShashInt3> &tiles, PlayerColor player, bool hide) override;
+	void changeFogOfWar(const CTileSet &tiles, PlayerColor player, bool hide) override;
 
 	bool isVisitCoveredByAnotherQuery(const CGObjectInstance *obj, const CGHeroInstance *hero) override;
 
@@ -229,7 +245,7 @@ public:
 	bool razeStructure(ObjectInstanceID tid, BuildingID bid);
 	bool disbandCreature( ObjectInstanceID id, SlotID pos );
 	bool arrangeStacks( ObjectInstanceID id1, ObjectInstanceID id2, ui8 what, SlotID p1, SlotID p2, si32 val, PlayerColor player);
-	void save(const std::string &fname);
+	void save(const std::string &fname, bool allowDelta = false);
 	void load(const std::string &fname);
 
 	void handleTimeEvents();
@@ -301,6 +317,9 @@ public:
 	friend class CVCMIServer;
 
 	CRandomGenerator & getRandomGenerator();
+	/// Gives random generator of calling thread seed that is recorded in journal or taken from replayed journal
+	void reseedRandomGenerator(EJournalThread::EJournalThread thread);
+	ui32 getAppliedPacksCount() const;
 
 private:
 	std::list<PlayerColor> generatePlayerTurnOrder() const;
@@ -0,0 +1,353 @@
+/*
+ * CGameJournal.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CGameJournal.h"
+
+#include "CGameHandler.h"
+#include "CVCMIServer.h"
+#include "../lib/CGameState.h"
+#include "../lib/NetPacks.h"
+#include "../lib/StartInfo.h"
+#include "../lib/mapping/CCampaignHandler.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/rmg/CMapGenOptions.h"
+#include "../lib/registerTypes/RegisterTypes.h"
+#include "../lib/serializer/Cast.h"
+#include "../lib/CThreadHelper.h"
+
+#include <boost/crc.hpp>
+
+namespace
+{
+	/// Calculates checksum of everything written into it
+	class CHashingWriter : public IBinaryWriter
+	{
+	public:
+		boost::crc_32_type crc;
+		BinarySerializer serializer;
+
+		CHashingWriter() : serializer(this)
+		{
+			registerTypes(serializer);
+		}
+
+		int write(const void * data, unsigned size) override
+		{
+			crc.process_bytes(data, size);
+			return size;
+		}
+	};
+}
+
+CGameJournal::CGameJournal(const boost::filesystem::path & fname)
+	: packSerializer(this)
+{
+	registerTypes(packSerializer);
+	packSerializer.smartPointerSerialization = false;
+	sendStackInstanceByIds = true;
+
+	file = make_unique<CSaveFile>(fname);
+	file->putMagicBytes(GAME_JOURNAL_MAGIC);
+	logGlobal->info("Recording game journal to %s", fname.string());
+}
+
+CGameJournal::~CGameJournal() = default;
+
+int CGameJournal::write(const void * data, unsigned size)
+{
+	auto oldSize = packBuffer.size();
+	packBuffer.resize(oldSize + size);
+	std::memcpy(packBuffer.data() + oldSize, data, size);
+	return size;
+}
+
+void CGameJournal::start(const StartInfo & si)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	*file << si;
+}
+
+void CGameJournal::recordRequest(CGameState * gs, const CPackForServer * pack, PlayerColor sender, ui32 appliedPacks, si32 seed)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	if(!smartVectorMembersSerialization)
+		addStdVecItems(gs);
+
+	packBuffer.clear();
+	packSerializer & pack;
+
+	ui8 entry = EJournalEntry::REQUEST;
+	ui32 length = static_cast<ui32>(packBuffer.size());
+	*file << entry << appliedPacks << seed << sender << length;
+	file->write(packBuffer.data(), length);
+}
+
+si32 CGameJournal::recordSeed(EJournalThread::EJournalThread thread)
+{
+	si32 seed = generateSeed();
+
+	boost::unique_lock<boost::mutex> lock(mx);
+	ui8 entry = EJournalEntry::RESEED;
+	ui8 threadId = thread;
+	*file << entry << threadId << seed;
+	return seed;
+}
+
+void CGameJournal::finish(ui32 appliedPacks)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	ui8 entry = EJournalEntry::END;
+	*file << entry << appliedPacks;
+}
+
+si32 CGameJournal::generateSeed()
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return seedSource.nextInt();
+}
+
+CGameReplay::CGameReplay(const boost::filesystem::path & fname, bool PrintHashes)
+	: finished(false), gameFinished(false), diverged(false), finalAppliedPacks(0), packReadPos(0), packDeserializer(this), printHashes(PrintHashes)
+{
+	registerTypes(packDeserializer);
+	packDeserializer.fileVersion = SERIALIZATION_VERSION;
+	packDeserializer.smartPointerSerialization = false;
+	sendStackInstanceByIds = true;
+
+	file = make_unique<CLoadFile>(fname);
+	file->checkMagicBytes(GAME_JOURNAL_MAGIC);
+}
+
+CGameReplay::~CGameReplay() = default;
+
+int CGameReplay::read(void * data, unsigned size)
+{
+	if(packBuffer.size() < packReadPos + size)
+		throw std::runtime_error("Cannot read past the recorded request!");
+
+	std::memcpy(data, packBuffer.data() + packReadPos, size);
+	packReadPos += size;
+	return size;
+}
+
+bool CGameReplay::readEntry()
+{
+	if(finished)
+		return false;
+
+	ui8 entry = EJournalEntry::END;
+	try
+	{
+		*file >> entry;
+	}
+	catch(std::exception &)
+	{
+		logGlobal->warn("Journal is truncated, probably recording server was terminated");
+		finished = true;
+		return false;
+	}
+
+	switch(entry)
+	{
+	case EJournalEntry::REQUEST:
+		{
+			Request request;
+			ui32 length = 0;
+			*file >> request.appliedPacks >> request.seed >> request.sender >> length;
+			request.data.resize(length);
+			file->read(request.data.data(), length);
+			pendingRequests.push_back(std::move(request));
+			return true;
+		}
+	case EJournalEntry::RESEED:
+		{
+			ui8 thread = 0;
+			si32 seed = 0;
+			*file >> thread >> seed;
+			if(thread >= EJournalThread::COUNT)
+			{
+				logGlobal->error("Journal is corrupted, unknown thread %d", static_cast<int>(thread));
+				finished = true;
+				return false;
+			}
+			pendingSeeds[thread].push_back(seed);
+			return true;
+		}
+	case EJournalEntry::END:
+		{
+			*file >> finalAppliedPacks;
+			finished = true;
+			return false;
+		}
+	default:
+		finished = true;
+		return false;
+	}
+}
+
+std::shared_ptr<StartInfo> CGameReplay::readStartInfo()
+{
+	auto si = std::make_shared<StartInfo>();
+	*file >> *si;
+	return si;
+}
+
+si32 CGameReplay::nextSeed(EJournalThread::EJournalThread thread)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	auto & seeds = pendingSeeds[thread];
+	while(seeds.empty() && readEntry())
+		continue;
+
+	if(seeds.empty())
+	{
+		logGlobal->error("Replay diverged: journal has no more random seeds for thread %d", static_cast<int>(thread));
+		diverged = true;
+		packApplied.notify_all();
+		return 0;
+	}
+
+	si32 seed = seeds.front();
+	seeds.pop_front();
+	return seed;
+}
+
+PlayerColor CGameReplay::currentSender() const
+{
+	return sender;
+}
+
+void CGameReplay::onPackApplied()
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	packApplied.notify_all();
+}
+
+void CGameReplay::turnStarted(CGameState * gs)
+{
+	if(!printHashes)
+		return;
+
+	auto now = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - turnStartTime).count();
+	turnStartTime = now;
+
+	logGlobal->info("Day %d: state hash %08x, replayed in %d ms", gs->day, calculateStateHash(gs), duration);
+}
+
+ui32 CGameReplay::calculateStateHash(CGameState * gs)
+{
+	CHashingWriter hasher;
+	hasher.serializer & gs;
+	return hasher.crc.checksum();
+}
+
+void CGameReplay::run(CVCMIServer & server)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	turnStartTime = startTime;
+
+	server.replay = this;
+	server.si = readStartInfo();
+	if(server.si->mode == StartInfo::CAMPAIGN)
+	{
+		server.campaignMap = *server.si->campState->currentMap;
+		server.campaignBonus = server.si->campState->chosenCampaignBonuses[server.campaignMap];
+	}
+	server.prepareToStartGame();
+	server.startGameImmidiately();
+
+	auto gh = server.gh;
+	addStdVecItems(gh->gameState());
+
+	boost::thread gameThread([&]()
+	{
+		setThreadName("CGameReplay::gameThread");
+		gh->run(server.si->mode == StartInfo::LOAD_GAME);
+
+		boost::unique_lock<boost::mutex> lock(mx);
+		gameFinished = true;
+		packApplied.notify_all();
+	});
+
+	// Wait till game handler applies as many packs as it did when request was received.
+	// Server that applied more packs than the journal says has diverged from recorded game
+	auto waitForAppliedPacks = [&](ui32 expected) -> bool
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		while(gh->getAppliedPacksCount() < expected && !gameFinished && !diverged)
+		{
+			// waiting is not an error - server threads may legitimately wait for something, only report it
+			if(!packApplied.timed_wait(lock, boost::posix_time::seconds(10)))
+				logGlobal->warn("Replay is waiting for server: %d of %d packs applied", gh->getAppliedPacksCount(), expected);
+		}
+
+		if(!diverged && gh->getAppliedPacksCount() != expected)
+		{
+			if(gh->getAppliedPacksCount() > expected)
+				logGlobal->error("Replay diverged: server applied %d packs while journal has %d", gh->getAppliedPacksCount(), expected);
+			else
+				logGlobal->error("Replay diverged: game ended after %d packs while journal has %d", gh->getAppliedPacksCount(), expected);
+			diverged = true;
+		}
+		return !diverged;
+	};
+
+	ui32 replayedRequests = 0;
+	while(server.state == EServerState::GAMEPLAY)
+	{
+		Request request;
+		{
+			boost::unique_lock<boost::mutex> lock(mx);
+			while(pendingRequests.empty() && readEntry())
+				continue;
+
+			if(pendingRequests.empty())
+				break;
+
+			request = std::move(pendingRequests.front());
+			pendingRequests.pop_front();
+		}
+
+		if(!waitForAppliedPacks(request.appliedPacks))
+			break;
+
+		packBuffer = std::move(request.data);
+		packReadPos = 0;
+		CPack * pack = nullptr;
+		packDeserializer & pack;
+
+		auto serverPack = dynamic_ptr_cast<CPackForServer>(pack);
+		if(!serverPack)
+		{
+			logGlobal->error("Journal contains unexpected pack %s", pack ? typeid(*pack).name() : "nullptr");
+			delete pack;
+			break;
+		}
+
+		sender = request.sender;
+		gh->getRandomGenerator().setSeed(request.seed);
+		gh->handleReceivedPack(serverPack);
+		replayedRequests++;
+	}
+
+	//let server finish processing of last request
+	if(finalAppliedPacks && !diverged && waitForAppliedPacks(finalAppliedPacks))
+		logGlobal->info("Replay matches journal");
+
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+	logGlobal->info("Replayed %d requests in %d ms, %d packs applied", replayedRequests, duration, gh->getAppliedPacksCount());
+	if(printHashes)
+		logGlobal->info("Final state hash %08x", calculateStateHash(gh->gameState()));
+
+	server.state = EServerState::SHUTDOWN;
+	gameThread.join();
+}
@@ -0,0 +1,116 @@
+/*
+ * CGameJournal.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../lib/serializer/BinarySerializer.h"
+#include "../lib/serializer/BinaryDeserializer.h"
+#include "../lib/CRandomGenerator.h"
+
+struct CPackForServer;
+struct StartInfo;
+class CGameState;
+class CVCMIServer;
+
+const std::string GAME_JOURNAL_MAGIC = "VCMIJRN";
+
+namespace EJournalEntry
+{
+	enum EJournalEntry : ui8
+	{
+		REQUEST, //pack received from client
+		RESEED, //random generator of game handler thread got new seed
+		END
+	};
+}
+
+namespace EJournalThread
+{
+	/// Server thread that reseeds its random generator. Same work is done by different system threads
+	/// when game is recorded and replayed, so seeds are matched by role of thread
+	enum EJournalThread : ui8
+	{
+		GAME, //game start, loading and new turns
+		BATTLE, //battle thread
+		COUNT
+	};
+}
+
+/// Records all requests received by game handler in order of arrival together with
+/// random seeds used by server threads. Game can be replayed from journal without clients by CGameReplay
+class CGameJournal : public IBinaryWriter
+{
+	boost::mutex mx;
+	std::vector<ui8> packBuffer;
+	BinarySerializer packSerializer;
+	std::unique_ptr<CSaveFile> file;
+	CRandomGenerator seedSource;
+
+	int write(const void * data, unsigned size) override;
+public:
+	CGameJournal(const boost::filesystem::path & fname);
+	~CGameJournal();
+
+	/// Must be called once, before game state is created. StartInfo must have seed set
+	void start(const StartInfo & si);
+	void recordRequest(CGameState * gs, const CPackForServer * pack, PlayerColor sender, ui32 appliedPacks, si32 seed);
+	/// Returns new seed for random generator of given thread
+	si32 recordSeed(EJournalThread::EJournalThread thread);
+	void finish(ui32 appliedPacks);
+	si32 generateSeed();
+};
+
+/// Re-executes recorded journal on local game handler, without networking and AI
+class CGameReplay : public IBinaryReader
+{
+	struct Request
+	{
+		ui32 appliedPacks;
+		si32 seed;
+		PlayerColor sender;
+		std::vector<ui8> data;
+	};
+
+	boost::mutex mx;
+	boost::condition_variable packApplied; //notified on every pack applied by game handler and when game thread ends
+	std::unique_ptr<CLoadFile> file;
+	std::list<Request> pendingRequests;
+	std::array<std::list<si32>, EJournalThread::COUNT> pendingSeeds;
+	bool finished;
+	bool gameFinished;
+	bool diverged;
+	ui32 finalAppliedPacks;
+
+	std::vector<ui8> packBuffer;
+	size_t packReadPos;
+	BinaryDeserializer packDeserializer;
+
+	PlayerColor sender;
+	bool printHashes;
+	std::chrono::steady_clock::time_point turnStartTime;
+
+	int read(void * data, unsigned size) override;
+	bool readEntry(); //returns false if end of journal was reached
+public:
+	CGameReplay(const boost::filesystem::path & fname, bool PrintHashes);
+	~CGameReplay();
+
+	std::shared_ptr<StartInfo> readStartInfo();
+	void run(CVCMIServer & server);
+
+	/// Returns next recorded seed of given thread
+	si32 nextSeed(EJournalThread::EJournalThread thread);
+	/// Player that sent request that is currently being replayed
+	PlayerColor currentSender() const;
+	void turnStarted(CGameState * gs);
+	/// Called by game handler after every applied pack
+	void onPackApplied();
+
+	static ui32 calculateStateHash(CGameState * gs);
+};
@@ -35,6 +35,7 @@
 #include "../lib/VCMI_Lib.h"
 #include "../lib/VCMIDirs.h"
 #include "CGameHandler.h"
+#include "CGameJournal.h"
 #include "../lib/mapping/CMapInfo.h"
 #include "../lib/GameConstants.h"
 #include "../lib/logging/CBasicLogConfigurator.h"
@@ -116,13 +117,16 @@ std::string NAME_AFFIX = "server";
 std::string NAME = GameConstants::VCMI_VERSION + std::string(" (") + NAME_AFFIX + ')';
 
 CVCMIServer::CVCMIServer(boost::program_options::variables_map & opts)
-	: port(3030), io(std::make_shared<boost::asio::io_service>()), state(EServerState::LOBBY), cmdLineOptions(opts), currentClientId(1), currentPlayerId(1), restartGameplay(false)
+	: port(3030), io(std::make_shared<boost::asio::io_service>()), state(EServerState::LOBBY), cmdLineOptions(opts), currentClientId(1), currentPlayerId(1), restartGameplay(false), replay(nullptr)
 {
 	uuid = boost::uuids::to_string(boost::uuids::random_generator()());
 	logNetwork->trace("CVCMIServer created! UUID: %s", uuid);
 	applier = std::make_shared<CApplier<CBaseForServerApply>>();
 	registerTypesLobbyPacks(*applier);
 
+	if(cmdLineOptions.count("replay"))
+		return; //replay doesn't need any connections
+
 	if(cmdLineOptions.count("port"))
 		port = cmdLineOptions["port"].as<ui16>();
 	logNetwork->info("Port %d will be used", port);
@@ -236,6 +240,11 @@ void CVCMIServer::prepareToStartGame()
 	}
 	state = EServerState::GAMEPLAY_STARTING;
 	gh = std::make_shared<CGameHandler>(this);
+	if(replay)
+		gh->replay = replay;
+	else if(cmdLineOptions.count("journal"))
+		gh->journal = make_unique<CGameJournal>(cmdLineOptions["journal"].as<std::string>());
+
 	switch(si->mode)
 	{
 	case StartInfo::CAMPAIGN:
@@ -867,7 +876,10 @@ static void handleCommandOptions(int argc, char * argv[], boost::program_options
 	("uuid", po::value<std::string>(), "")
 	("enable-shm-uuid", "use UUID for shared memory identifier")
 	("enable-shm", "enable usage of shared memory")
-	("port", po::value<ui16>(), "port at which server will listen to connections from client");
+	("port", po::value<ui16>(), "port at which server will listen to connections from client")
+	("journal", po::value<std::string>(), "record all requests of the game into given file, so game can be replayed later")
+	("replay", po::value<std::string>(), "replay game recorded with --journal without clients and exit")
+	("replay-hashes", "print game state hash on every turn of replay");
 
 	if(argc > 1)
 	{
@@ -927,6 +939,17 @@ int main(int argc, char * argv[])
 
 	loadDLLClasses();
 	srand((ui32)time(nullptr));
+	if(opts.count("replay"))
+	{
+		CVCMIServer server(opts);
+		CGameReplay replay(opts["replay"].as<std::string>(), opts.count("replay-hashes"));
+		replay.run(server);
+
+		logConfig.deconfigure();
+		vstd::clear_pointer(VLC);
+		return 0;
+	}
+
 	try
 	{
 		boost::asio::io_service io_service;
@@ -18,6 +18,7 @@ class CMapInfo;
 
 struct CPackForLobby;
 class CGameHandler;
+class CGameReplay;
 struct SharedMemory;
 
 struct StartInfo;
@@ -51,6 +52,7 @@ class CVCMIServer : public LobbyInfo
 
 public:
 	std::shared_ptr<CGameHandler> gh;
+	CGameReplay * replay; //if set, game is replayed from journal instead of being played by clients
 	std::atomic<EServerState> state;
 	ui16 port;
 
@@ -82,7 +82,7 @@ CGameState * CPackForServer::GS(CGameHandler * gh)
 
 bool SaveGame::applyGh(CGameHandler * gh)
 {
-	gh->save(fname);
+	gh->save(fname, allowDelta);
 	logGlobal->info("Game has been saved as %s", fname);
 	return true;
 }
@@ -375,3 +375,59 @@ bool PlayerMessage::applyGh(CGameHandler * gh)
 	gh->playerMessage(player, text, currObj);
 	return true;
 }
+
+bool PlayerBlocked::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool InfoWindow::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool BlockingDialog::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool GarrisonDialog::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return gh->getOwner(hid) == player;
+}
+
+bool ExchangeDialog::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool TeleportDialog::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool MapObjectSelectDialog::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool ShowInInfobox::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool AdvmapSpellCast::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	const CGObjectInstance * caster = gh->getObj(casterID, false);
+	return caster && gh->gameState()->isVisible(caster, player);
+}
+
+bool ShowWorldViewEx::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
+
+bool CenterView::visibleTo(CGameHandler * gh, PlayerColor player) const
+{
+	return this->player == player;
+}
@@ -0,0 +1,125 @@
+/*
+ * CSaveCheckpointsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/serializer/CPackJournal.h"
+
+class CSaveCheckpointsTest : public ::testing::Test
+{
+public:
+	const std::string extension = ".vsgm1";
+
+	boost::filesystem::path directory;
+	CSaveCheckpoints subject;
+	std::map<std::string, std::string> checkpointOfSave; //save name -> checkpoint name, empty for full saves
+
+	void SetUp() override
+	{
+		directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		boost::filesystem::create_directories(directory);
+	}
+
+	void TearDown() override
+	{
+		boost::filesystem::remove_all(directory);
+	}
+
+	void writeFile(const std::string & name)
+	{
+		boost::filesystem::ofstream file(directory / (name + extension));
+		file << name;
+	}
+
+	//same steps as in CGameHandler::save
+	void save(const std::string & name, bool autosave, ui32 maxDeltaSaves)
+	{
+		const bool newCheckpoint = autosave && !subject.canSaveDelta(directory, extension, maxDeltaSaves);
+		if(newCheckpoint)
+			writeFile(subject.startCheckpoint().name);
+
+		writeFile(name);
+		if(autosave)
+			subject.deltaSaved();
+		checkpointOfSave[name] = autosave ? subject.getCurrent().name : "";
+
+		if(newCheckpoint)
+		{
+			subject.removeUnused(directory, extension, [&](const boost::filesystem::path & path)
+			{
+				return checkpointOfSave.at(path.stem().string());
+			});
+		}
+	}
+
+	void checkSaves()
+	{
+		size_t checkpointFiles = 0;
+		for(boost::filesystem::directory_iterator it(directory), end; it != end; ++it)
+		{
+			if(CSaveCheckpoints::isCheckpointFile(it->path()))
+				checkpointFiles++;
+		}
+
+		std::set<std::string> used;
+		for(auto & save : checkpointOfSave)
+		{
+			if(save.second.empty())
+				continue;
+			used.insert(save.second);
+			EXPECT_TRUE(boost::filesystem::exists(directory / (save.second + extension))) << save.first << " lost its checkpoint";
+		}
+		//checkpoint whose last save was just overwritten is removed when next checkpoint is started
+		EXPECT_LE(checkpointFiles, used.size() + 1);
+	}
+};
+
+TEST_F(CSaveCheckpointsTest, rotationPastCheckpoint)
+{
+	save("Autosave_1", true, 3);
+	const SaveCheckpoint first = subject.getCurrent();
+
+	for(int i = 1; i < 23; i++)
+	{
+		save("Autosave_" + boost::lexical_cast<std::string>(i % 5 + 1), true, 3);
+		checkSaves();
+	}
+
+	//all deltas of first checkpoint were rotated out, so its file was removed
+	EXPECT_NE(subject.getCurrent().token, first.token);
+	EXPECT_FALSE(boost::filesystem::exists(CSaveCheckpoints::getPath(directory, first, extension)));
+}
+
+TEST_F(CSaveCheckpointsTest, manualSaveDoesNotReplaceCheckpoint)
+{
+	save("Autosave_1", true, 5);
+	const SaveCheckpoint checkpoint = subject.getCurrent();
+
+	save("Autosave_1", false, 5);
+	save("Autosave_2", true, 5);
+	checkSaves();
+
+	EXPECT_EQ(subject.getCurrent().token, checkpoint.token);
+	EXPECT_TRUE(boost::filesystem::exists(CSaveCheckpoints::getPath(directory, checkpoint, extension)));
+}
+
+TEST_F(CSaveCheckpointsTest, missingCheckpointStartsNewOne)
+{
+	save("Autosave_1", true, 5);
+	const SaveCheckpoint checkpoint = subject.getCurrent();
+	EXPECT_TRUE(subject.canSaveDelta(directory, extension, 5));
+	EXPECT_FALSE(subject.canSaveDelta(directory, extension, 1));
+
+	boost::filesystem::remove(CSaveCheckpoints::getPath(directory, checkpoint, extension));
+	EXPECT_FALSE(subject.canSaveDelta(directory, extension, 5));
+
+	save("Autosave_2", true, 5);
+	EXPECT_NE(subject.getCurrent().token, checkpoint.token);
+	EXPECT_TRUE(boost::filesystem::exists(CSaveCheckpoints::getPath(directory, subject.getCurrent(), extension)));
+}
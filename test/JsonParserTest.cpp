@@ -0,0 +1,79 @@
+/*
+ * JsonParserTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/JsonNode.h"
+#include "../lib/filesystem/Filesystem.h"
+
+static JsonNode parse(const std::string & text)
+{
+	return JsonNode(text.c_str(), text.size());
+}
+
+TEST(JsonParserTest, longStrings)
+{
+	const std::string longText(100, 'x');
+	JsonNode node = parse("[\"" + longText + "\", \"" + longText + "\\n" + longText + "\", \"short\\\"quoted\\\"\"]");
+
+	ASSERT_EQ(node.Vector().size(), 3);
+	EXPECT_EQ(node.Vector()[0].String(), longText);
+	EXPECT_EQ(node.Vector()[1].String(), longText + "\n" + longText);
+	EXPECT_EQ(node.Vector()[2].String(), "short\"quoted\"");
+}
+
+TEST(JsonParserTest, lenientSyntax)
+{
+	const std::string text =
+		"// comment before data\n"
+		"{\n"
+		"\t\t\t\t\t\t\t\t\t\t\t\t\"first\" : 1, // trailing comment\n"
+		"\t\"second#override\" : [ 1, 2, ],\n"
+		"                                \"third\" : { \"nested\" : true, },\n"
+		"}\n"
+		"// comment after data";
+	JsonNode node = parse(text);
+
+	EXPECT_EQ(node["first"].Integer(), 1);
+	EXPECT_EQ(node["second"].Vector().size(), 2);
+	EXPECT_EQ(node["second"].flags, std::vector<std::string>{"override"});
+	EXPECT_TRUE(node["third"]["nested"].Bool());
+}
+
+// Measures parsing of all json files from config directory, run with --gtest_also_run_disabled_tests
+TEST(JsonParserTest, DISABLED_configBenchmark)
+{
+	const int iterations = 20;
+
+	auto files = CResourceHandler::get()->getFilteredFiles([](const ResourceID & ident)
+	{
+		return ident.getType() == EResType::TEXT && boost::algorithm::starts_with(ident.getName(), "CONFIG/");
+	});
+
+	std::vector<std::pair<std::unique_ptr<ui8[]>, si64>> contents;
+	size_t totalSize = 0;
+	for(auto & file : files)
+	{
+		contents.push_back(CResourceHandler::get()->load(file)->readAll());
+		totalSize += contents.back().second;
+	}
+	ASSERT_FALSE(contents.empty());
+
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < iterations; i++)
+	{
+		for(auto & content : contents)
+			JsonNode node(reinterpret_cast<char *>(content.first.get()), content.second);
+	}
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	double megabytes = totalSize * iterations / 1024.0 / 1024.0;
+	std::cout << "Parsed " << contents.size() << " files (" << totalSize << " bytes) " << iterations << " times in "
+		<< duration / 1000 << " ms, " << megabytes / (duration / 1000000.0) << " MB/s" << std::endl;
+}
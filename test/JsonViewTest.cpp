@@ -0,0 +1,123 @@
+/*
+ * JsonViewTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/JsonView.h"
+
+static JsonNode parse(const std::string & text)
+{
+	return JsonNode(text.c_str(), text.size());
+}
+
+TEST(JsonViewTest, scalars)
+{
+	JsonNode source = parse("{\"flag\" : true, \"float\" : 1.5, \"integer\" : 42, \"string\" : \"text\"}");
+	JsonTree subject(source);
+	JsonView root = subject.root();
+
+	EXPECT_EQ(root.getType(), JsonNode::JsonType::DATA_STRUCT);
+	EXPECT_EQ(root.size(), 4);
+	EXPECT_TRUE(root["flag"].Bool());
+	EXPECT_DOUBLE_EQ(root["float"].Float(), 1.5);
+	EXPECT_EQ(root["integer"].Integer(), 42);
+	EXPECT_DOUBLE_EQ(root["integer"].Float(), 42);
+	EXPECT_EQ(root["string"].String(), "text");
+}
+
+TEST(JsonViewTest, missingEntries)
+{
+	JsonNode source = parse("{\"vector\" : [1, 2], \"struct\" : {\"a\" : 1}}");
+	JsonTree subject(source);
+	JsonView root = subject.root();
+
+	EXPECT_TRUE(root["missing"].isNull());
+	EXPECT_TRUE(root["struct"]["vector"].isNull()); //key exists in tree, but not in this struct
+	EXPECT_TRUE(root["vector"]["a"].isNull());
+	EXPECT_TRUE(root["vector"][2].isNull());
+	EXPECT_EQ(root["missing"]["deeper"].Integer(), 0);
+	EXPECT_EQ(root["missing"].String(), "");
+}
+
+TEST(JsonViewTest, orderMatchesJsonMap)
+{
+	JsonNode source = parse("{\"c\" : 3, \"a\" : 1, \"b\" : [10, 20, 30]}");
+	JsonTree subject(source);
+	JsonView root = subject.root();
+
+	ASSERT_EQ(root.size(), 3);
+	EXPECT_EQ(root.keyAt(0), "a");
+	EXPECT_EQ(root.keyAt(1), "b");
+	EXPECT_EQ(root.keyAt(2), "c");
+	EXPECT_EQ(root[2].Integer(), 3);
+
+	JsonView vector = root["b"];
+	ASSERT_EQ(vector.size(), 3);
+	EXPECT_EQ(vector[0].Integer(), 10);
+	EXPECT_EQ(vector[2].Integer(), 30);
+}
+
+TEST(JsonViewTest, convertsBack)
+{
+	JsonNode source = parse("{\"list\" : [{\"name\" : \"first\"}, {\"name\" : \"second\", \"value\" : -1}], \"empty\" : {}, \"null\" : null}");
+	source.setMeta("core");
+	JsonTree subject(source);
+
+	JsonNode result = subject.root().toJsonNode();
+	EXPECT_EQ(result, source);
+	EXPECT_EQ(subject.root()["list"][1]["name"].meta(), "core");
+	EXPECT_EQ(result["list"].Vector()[1]["name"].meta, "core");
+}
+
+TEST(JsonViewTest, parsedMatchesConverted)
+{
+	const std::string text =
+		"// comment\n"
+		"{\n"
+		"\t\"zeta\" : [1, -2.5, 3e2, true, false, null, \"x\\ty\\\"z\", [], {}],\n"
+		"\t\"alpha\" : {\"inner\" : {\"zeta\" : \"deep\", \"alpha#override\" : 7}, \"list\" : [[1], [2, [3]]]},\n"
+		"\t\"mid\" : \"\",\n"
+		"}\n";
+
+	JsonNode source = parse(text);
+	JsonTree subject(text.c_str(), text.size());
+	JsonView root = subject.root();
+
+	EXPECT_EQ(root.toJsonNode(), source);
+	ASSERT_EQ(root.size(), 3);
+	EXPECT_EQ(root.keyAt(0), "alpha");
+	EXPECT_EQ(root.keyAt(2), "zeta");
+	EXPECT_EQ(root["alpha"]["inner"]["alpha"].Integer(), 7);
+	EXPECT_EQ(root["alpha"]["list"][1][1][0].Integer(), 3);
+	EXPECT_EQ(root["zeta"][6].String(), "x\ty\"z");
+	EXPECT_DOUBLE_EQ(root["zeta"][2].Float(), 300);
+	EXPECT_TRUE(root["zeta"][5].isNull());
+	EXPECT_EQ(root["zeta"][8].getType(), JsonNode::JsonType::DATA_STRUCT);
+	EXPECT_EQ(root["alpha"]["inner"]["zeta"].meta(), "");
+}
+
+TEST(JsonViewTest, parsedScalarRoot)
+{
+	JsonTree number("42 ", 3);
+	EXPECT_EQ(number.root().Integer(), 42);
+
+	JsonTree empty("", 0);
+	EXPECT_TRUE(empty.root().isNull());
+}
+
+TEST(JsonViewTest, parsedDuplicatedKeyKeepsLast)
+{
+	const std::string text = "{\"b\" : 1, \"a\" : {\"c\" : 2}, \"b\" : 3}";
+	JsonTree subject(text.c_str(), text.size());
+	JsonView root = subject.root();
+
+	ASSERT_EQ(root.size(), 2);
+	EXPECT_EQ(root["a"]["c"].Integer(), 2);
+	EXPECT_EQ(root["b"].Integer(), 3);
+}
@@ -0,0 +1,155 @@
+/*
+ * CMapObjectIndexTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/mapping/CMapObjectIndex.h"
+#include "../../lib/mapObjects/CObjectHandler.h"
+#include "../../lib/CRandomGenerator.h"
+
+class CMapObjectIndexTest : public ::testing::Test
+{
+public:
+	const int3 mapSize = int3(45, 30, 2);
+
+	CMapObjectIndex subject;
+	std::vector<std::unique_ptr<CGObjectInstance>> objects;
+	CRandomGenerator rand;
+
+	void SetUp() override
+	{
+		rand.setSeed(42);
+		subject.reset(mapSize);
+
+		for(int i = 0; i < 300; i++)
+		{
+			objects.push_back(make_unique<CGObjectInstance>());
+			objects.back()->id = ObjectInstanceID(i);
+			randomize(*objects.back());
+		}
+	}
+
+	//objects without appearance can't be visited, so their position is pos
+	void randomize(CGObjectInstance & obj)
+	{
+		obj.pos = int3(rand.nextInt(-1, mapSize.x), rand.nextInt(0, mapSize.y - 1), rand.nextInt(0, mapSize.z - 1));
+		obj.ID = rand.nextInt(0, 2) ? Obj::MONSTER : Obj::MINE;
+		obj.tempOwner = PlayerColor(rand.nextInt(0, 2));
+	}
+
+	std::vector<CGObjectInstance *> expected(const std::function<bool(const CGObjectInstance &)> & condition)
+	{
+		std::vector<CGObjectInstance *> ret;
+		for(auto & obj : objects)
+		{
+			if(subject.contains(obj.get()) && condition(*obj))
+				ret.push_back(obj.get());
+		}
+		return ret;
+	}
+
+	void checkQueries()
+	{
+		for(int i = 0; i < 30; i++)
+		{
+			int3 topLeft(rand.nextInt(-3, mapSize.x), rand.nextInt(-3, mapSize.y), rand.nextInt(0, mapSize.z - 1));
+			int3 bottomRight = topLeft + int3(rand.nextInt(0, 20), rand.nextInt(0, 20), 0);
+			EXPECT_EQ(subject.getObjectsInRect(topLeft, bottomRight), expected([&](const CGObjectInstance & obj)
+			{
+				return obj.pos.z == topLeft.z && obj.pos.x >= topLeft.x && obj.pos.x <= bottomRight.x && obj.pos.y >= topLeft.y && obj.pos.y <= bottomRight.y;
+			}));
+
+			ui32 distanceSQ = rand.nextInt(0, 100);
+			EXPECT_EQ(subject.getObjectsWithin(topLeft, distanceSQ), expected([&](const CGObjectInstance & obj)
+			{
+				return obj.pos.z == topLeft.z && obj.pos.dist2dSQ(topLeft) <= distanceSQ;
+			}));
+		}
+
+		for(Obj type : {Obj::MONSTER, Obj::MINE, Obj::TOWN})
+		{
+			EXPECT_EQ(subject.getObjectsOfType(type), expected([&](const CGObjectInstance & obj)
+			{
+				return obj.ID == type;
+			}));
+		}
+
+		for(int owner = 0; owner < 4; owner++)
+		{
+			EXPECT_EQ(subject.getObjectsOfOwner(PlayerColor(owner)), expected([&](const CGObjectInstance & obj)
+			{
+				return obj.tempOwner == PlayerColor(owner);
+			}));
+		}
+	}
+};
+
+TEST_F(CMapObjectIndexTest, matchesFullScan)
+{
+	for(auto & obj : objects)
+		subject.add(obj.get());
+	checkQueries();
+
+	for(int i = 0; i < 500; i++)
+	{
+		CGObjectInstance * obj = objects[rand.nextInt(0, objects.size() - 1)].get();
+		switch(rand.nextInt(0, 2))
+		{
+		case 0:
+			subject.remove(obj);
+			break;
+		case 1:
+			randomize(*obj);
+			subject.add(obj);
+			break;
+		default:
+			randomize(*obj);
+			subject.update(obj);
+			break;
+		}
+	}
+	checkQueries();
+}
+
+TEST_F(CMapObjectIndexTest, updateIgnoresMissingObjects)
+{
+	subject.update(objects[0].get());
+	EXPECT_FALSE(subject.contains(objects[0].get()));
+
+	subject.add(objects[0].get());
+	subject.reset(mapSize);
+	EXPECT_FALSE(subject.contains(objects[0].get()));
+	EXPECT_TRUE(subject.getObjectsOfType(objects[0]->ID).empty());
+}
+
+TEST_F(CMapObjectIndexTest, objectTakesIdOfAnotherObject)
+{
+	CGObjectInstance * placeholder = objects[5].get();
+	placeholder->ID = Obj::HERO_PLACEHOLDER;
+	subject.add(placeholder);
+
+	auto hero = make_unique<CGObjectInstance>();
+	hero->id = placeholder->id;
+	hero->ID = Obj::HERO;
+	hero->pos = int3(mapSize.x - 1, mapSize.y - 1, 1);
+	hero->tempOwner = PlayerColor(1);
+	EXPECT_FALSE(subject.contains(hero.get()));
+
+	subject.add(hero.get());
+	EXPECT_TRUE(subject.contains(hero.get()));
+	EXPECT_FALSE(subject.contains(placeholder));
+	EXPECT_TRUE(subject.getObjectsOfType(Obj::HERO_PLACEHOLDER).empty());
+	EXPECT_EQ(subject.getAllObjects(), std::vector<CGObjectInstance *>{hero.get()});
+	EXPECT_FALSE(vstd::contains(subject.getObjectsInRect(int3(0, 0, placeholder->pos.z), int3(mapSize.x - 1, mapSize.y - 1, placeholder->pos.z)), placeholder));
+
+	//removing replaced object must not touch its successor
+	subject.remove(placeholder);
+	EXPECT_TRUE(subject.contains(hero.get()));
+	EXPECT_EQ(subject.getObjectsOfType(Obj::HERO), std::vector<CGObjectInstance *>{hero.get()});
+}
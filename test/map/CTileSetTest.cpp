@@ -0,0 +1,171 @@
+/*
+ * CTileSetTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/mapping/CTileSet.h"
+#include "../../lib/CRandomGenerator.h"
+#include "../../lib/serializer/CMemorySerializer.h"
+
+TEST(CTileSetTest, matchesStdSet)
+{
+	const int3 mapSize(37, 23, 2);
+	CRandomGenerator rand;
+	rand.setSeed(42);
+
+	CTileSet subject(mapSize);
+	std::set<int3> expected;
+
+	for(int i = 0; i < 2000; i++)
+	{
+		int3 tile(rand.nextInt(0, mapSize.x - 1), rand.nextInt(0, mapSize.y - 1), rand.nextInt(0, mapSize.z - 1));
+		if(rand.nextInt(0, 2))
+			EXPECT_EQ(subject.insert(tile), expected.insert(tile).second);
+		else
+			EXPECT_EQ(subject.erase(tile), expected.erase(tile) > 0);
+	}
+
+	ASSERT_EQ(subject.size(), expected.size());
+	EXPECT_TRUE(std::equal(subject.begin(), subject.end(), expected.begin()));
+	EXPECT_TRUE(std::equal(boost::rbegin(subject), boost::rend(subject), expected.rbegin()));
+
+	for(auto tile : expected)
+		EXPECT_TRUE(subject.contains(tile));
+}
+
+TEST(CTileSetTest, tilesOutsideOfMap)
+{
+	CTileSet subject(int3(10, 10, 1));
+
+	EXPECT_FALSE(subject.insert(int3(-1, 0, 0)));
+	EXPECT_FALSE(subject.insert(int3(0, 10, 0)));
+	EXPECT_FALSE(subject.insert(int3(0, 0, 1)));
+	EXPECT_FALSE(subject.contains(int3(10, 0, 0)));
+	EXPECT_TRUE(subject.empty());
+	EXPECT_EQ(subject.begin(), subject.end());
+}
+
+TEST(CTileSetTest, eraseWhileIterating)
+{
+	CTileSet subject(int3(70, 3, 1));
+	for(int x = 0; x < 70; x++)
+		subject.insert(int3(x, 1, 0));
+
+	for(auto tile : subject)
+	{
+		if(tile.x % 2)
+			subject.erase(tile);
+	}
+
+	EXPECT_EQ(subject.size(), 35);
+	EXPECT_EQ(*subject.begin(), int3(0, 1, 0));
+	EXPECT_EQ(*boost::rbegin(subject), int3(68, 1, 0));
+}
+
+TEST(CTileSetTest, setAlgebra)
+{
+	const int3 mapSize(100, 100, 1);
+	CTileSet a(mapSize), b(mapSize);
+	for(int x = 0; x < 60; x++)
+		a.insert(int3(x, 50, 0));
+	for(int x = 40; x < 100; x++)
+		b.insert(int3(x, 50, 0));
+
+	CTileSet both = a;
+	both &= b;
+	EXPECT_EQ(both.size(), 20);
+	EXPECT_EQ(*both.begin(), int3(40, 50, 0));
+
+	CTileSet any = a;
+	any |= b;
+	EXPECT_EQ(any.size(), 100);
+
+	CTileSet onlyA = a;
+	onlyA -= b;
+	EXPECT_EQ(onlyA.size(), 40);
+	EXPECT_FALSE(onlyA.intersects(b));
+	EXPECT_TRUE(a.intersects(b));
+
+	onlyA |= both;
+	EXPECT_EQ(onlyA, a);
+}
+
+TEST(CTileSetTest, distanceQueries)
+{
+	const int3 mapSize(45, 31, 2);
+	CRandomGenerator rand;
+	rand.setSeed(7);
+
+	CTileSet subject(mapSize);
+	std::set<int3> expected;
+	EXPECT_FALSE(subject.findClosest(int3(3, 3, 0)).valid());
+
+	for(int i = 0; i < 40; i++)
+	{
+		int3 tile(rand.nextInt(0, mapSize.x - 1), rand.nextInt(0, mapSize.y - 1), rand.nextInt(0, mapSize.z - 1));
+		subject.insert(tile);
+		expected.insert(tile);
+
+		for(int j = 0; j < 20; j++)
+		{
+			int3 query(rand.nextInt(-2, mapSize.x + 1), rand.nextInt(-2, mapSize.y + 1), 0);
+			EXPECT_EQ(subject.findClosest(query), findClosestTile(expected, query));
+
+			ui32 distance = rand.nextInt(0, 50);
+			bool within = std::any_of(expected.begin(), expected.end(), [&](const int3 & tile)
+			{
+				return query.dist2dSQ(tile) <= distance;
+			});
+			EXPECT_EQ(subject.hasTileWithin(query, distance), within);
+		}
+	}
+}
+
+TEST(CTileSetTest, serialization)
+{
+	const int3 mapSize(70, 9, 2);
+	CTileSet empty(mapSize);
+	auto emptyCopy = CMemorySerializer::deepCopy(empty);
+	EXPECT_EQ(emptyCopy->getMapSize(), mapSize);
+	EXPECT_TRUE(emptyCopy->empty());
+
+	CTileSet subject(mapSize);
+	subject.insert(int3(5, 3, 0));
+	subject.insert(int3(69, 8, 1));
+	subject.insert(int3(40, 4, 1));
+
+	auto copy = CMemorySerializer::deepCopy(subject);
+	EXPECT_EQ(copy->getMapSize(), mapSize);
+	EXPECT_EQ(std::vector<int3>(copy->begin(), copy->end()), std::vector<int3>(subject.begin(), subject.end()));
+}
+
+TEST(CTileSetTest, corruptedSizeIsRejected)
+{
+	auto load = [](const int3 & mapSize, ui32 firstWord, const std::vector<ui64> & words)
+	{
+		CMemorySerializer mem;
+		int3 size = mapSize;
+		mem.oser & size;
+		mem.oser & firstWord;
+		mem.oser & words;
+
+		CTileSet result;
+		mem.iser & result;
+		return result;
+	};
+
+	EXPECT_THROW(load(int3(2000000000, 2000000000, 2), 0, std::vector<ui64>()), std::runtime_error);
+	EXPECT_THROW(load(int3(-5, 10, 1), 0, std::vector<ui64>()), std::runtime_error);
+	EXPECT_THROW(load(int3(10, 10, 3), 0, std::vector<ui64>()), std::runtime_error);
+	EXPECT_THROW(load(int3(10, 10, 1), 1, std::vector<ui64>(2, 1)), std::runtime_error);
+
+	CTileSet valid = load(int3(10, 10, 1), 1, std::vector<ui64>(1, 1));
+	EXPECT_EQ(valid.getMapSize(), int3(10, 10, 1));
+	EXPECT_EQ(std::vector<int3>(valid.begin(), valid.end()), std::vector<int3>{int3(4, 6, 0)});
+}
@@ -83,7 +83,7 @@ public:
 	void changeObjPos(ObjectInstanceID objid, int3 newPos, ui8 flags) override {};
 	void heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2) override {}; //when two heroes meet on adventure map
 	void changeFogOfWar(int3 center, ui32 radius, PlayerColor player, bool hide) override {};
-	void changeFogOfWar(std::unordered_set<int3, ShashInt3> &tiles, PlayerColor player, bool hide) override {};
+	void changeFogOfWar(const CTileSet &tiles, PlayerColor player, bool hide) override {};
 
 	///useful callback methods
 	void commitPackage(CPackForClient * pack) override;
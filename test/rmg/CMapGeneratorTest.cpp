@@ -0,0 +1,169 @@
+/*
+ * CMapGeneratorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include <boost/crc.hpp>
+
+#include "../../lib/CStopWatch.h"
+#include "../../lib/JsonNode.h"
+#include "../../lib/VCMI_Lib.h"
+#include "../../lib/filesystem/ResourceID.h"
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/mapObjects/CObjectHandler.h"
+#include "../../lib/rmg/CMapGenerator.h"
+#include "../../lib/rmg/CMapGenOptions.h"
+#include "../../lib/rmg/CRmgTemplate.h"
+#include "../../lib/rmg/CRmgTemplateStorage.h"
+#include "../../lib/serializer/JsonDeserializer.h"
+
+static const int BENCHMARK_RANDOM_SEED = 1337;
+
+/// Checksum of terrain and objects, same seed and options must always give same value
+static ui32 mapChecksum(const CMap & map)
+{
+	boost::crc_32_type result;
+	auto process = [&result](si64 value)
+	{
+		result.process_bytes(&value, sizeof(value));
+	};
+
+	for(int z = 0; z < (map.twoLevel ? 2 : 1); z++)
+	{
+		for(int y = 0; y < map.height; y++)
+		{
+			for(int x = 0; x < map.width; x++)
+			{
+				const TerrainTile & tile = map.getTile(int3(x, y, z));
+				process(tile.terType);
+				process(tile.terView);
+				process(tile.riverType);
+				process(tile.riverDir);
+				process(tile.roadType);
+				process(tile.roadDir);
+				process(tile.extTileFlags);
+				process(tile.visitable);
+				process(tile.blocked);
+			}
+		}
+	}
+
+	for(auto & object : map.objects)
+	{
+		if(!object)
+			continue;
+		process(object->ID);
+		process(object->subID);
+		process(object->pos.x);
+		process(object->pos.y);
+		process(object->pos.z);
+		result.process_bytes(object->instanceName.data(), object->instanceName.size());
+	}
+
+	process(map.grailPos.x);
+	process(map.grailPos.y);
+	process(map.grailPos.z);
+	return result.checksum();
+}
+
+static void setOptions(CMapGenOptions & options, const CRmgTemplate * tpl, int size, bool underground, int players, EWaterContent::EWaterContent water)
+{
+	options.setMapTemplate(tpl);
+	options.setWidth(size);
+	options.setHeight(size);
+	options.setHasTwoLevels(underground);
+	options.setPlayerCount(players);
+	options.setWaterContent(water);
+}
+
+// Zones, paths and placement attempts are processed on multiple threads, result must not depend on their count
+TEST(CMapGeneratorTest, sameMapForAnyThreadsCount)
+{
+	const JsonNode testData(ResourceID("test/rmg/1.json"));
+	CRmgTemplate tpl;
+	tpl.setId("2SM2a");
+	{
+		JsonDeserializer handler(nullptr, testData["2SM2a"]);
+		tpl.serializeJson(handler);
+	}
+	tpl.validate();
+
+	const int threadsCounts[] = {1, 4};
+	ui32 checksums[2];
+	for(int run = 0; run < 2; run++)
+	{
+		CMapGenOptions options;
+		setOptions(options, &tpl, CMapHeader::MAP_SIZE_SMALL, false, 2, EWaterContent::NONE);
+
+		CMapGenerator generator;
+		generator.setThreadsCount(threadsCounts[run]);
+		auto map = generator.generate(&options, BENCHMARK_RANDOM_SEED);
+		ASSERT_TRUE(map != nullptr);
+		checksums[run] = mapChecksum(*map);
+	}
+	EXPECT_EQ(checksums[0], checksums[1]);
+}
+
+// Generates maps from every template for every size, water content and player count it allows, each of them on one thread
+// and on multiple threads. Both maps must be equal, prints time of generator phases, growth of resident memory while map is alive
+// and peak memory of whole process so far. Run with --gtest_also_run_disabled_tests
+TEST(CMapGeneratorTest, DISABLED_templatesBenchmark)
+{
+	const int threadsCounts[] = {1, std::max<int>(4, boost::thread::hardware_concurrency())};
+	const int sizes[] = {CMapHeader::MAP_SIZE_SMALL, CMapHeader::MAP_SIZE_MIDDLE, CMapHeader::MAP_SIZE_LARGE, CMapHeader::MAP_SIZE_XLARGE};
+	const EWaterContent::EWaterContent waterContents[] = {EWaterContent::NONE, EWaterContent::NORMAL, EWaterContent::ISLANDS};
+
+	const auto & templates = VLC->tplh->getTemplates();
+	ASSERT_FALSE(templates.empty());
+
+	for(auto & entry : templates)
+	{
+		const CRmgTemplate * tpl = entry.second;
+
+		for(int size : sizes)
+		{
+			for(bool underground : {false, true})
+			{
+				if(!tpl->matchesSize(int3(size, size, underground ? 2 : 1)))
+					continue;
+
+				for(int players : tpl->getPlayers().getNumbers())
+				{
+					for(auto water : waterContents)
+					{
+						const std::string description = boost::str(boost::format("%s %dx%d%s, %d players, water %d")
+							% tpl->getName() % size % size % (underground ? "x2" : "") % players % static_cast<int>(water));
+
+						ui32 checksums[2];
+						for(int run = 0; run < 2; run++)
+						{
+							CMapGenOptions options;
+							setOptions(options, tpl, size, underground, players, water);
+
+							CMemoryWatch memory;
+							CMapGenerator generator;
+							generator.setThreadsCount(threadsCounts[run]);
+							auto start = std::chrono::steady_clock::now();
+							auto map = generator.generate(&options, BENCHMARK_RANDOM_SEED);
+							auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+							checksums[run] = mapChecksum(*map);
+
+							std::cout << description << ", " << threadsCounts[run] << " threads: " << duration << " ms (";
+							for(auto & phase : generator.getPhaseTimes())
+								std::cout << phase.first << " " << phase.second << " ms, ";
+							std::cout << "memory +" << memory.getDiff() << " KB, process peak " << CMemoryWatch::peak() << " KB), checksum " << std::hex << checksums[run] << std::dec << std::endl;
+						}
+						EXPECT_EQ(checksums[0], checksums[1]) << description << ", map generated on multiple threads differs";
+					}
+				}
+			}
+		}
+	}
+}